@@ -20,6 +20,8 @@
 /* Attributes */
 #define WBAA_Dummy               (TAG_USER | 0x40400000)
 #define WBAA_Screen              (WBAA_Dummy+0)         // (struct Screen *)
+#define WBAA_Status              (WBAA_Dummy+1)         // (CONST_STRPTR) Progress of background jobs, or NULL if idle. [G]
+#define WBAA_CopyFlags           (WBAA_Dummy+2)         // (ULONG) WBCOPYF_* flags for new background jobs. [G]
 
 /* Methods */
 #define WBAM_Dummy               (TAG_USER | 0x40400100)
@@ -31,6 +33,11 @@
 #define WBAM_DragDropUpdate      (WBAM_Dummy+5)         // Update
 #define WBAM_DragDropEnd         (WBAM_Dummy+6)         // Leave drag/drop mode.
 #define WBAM_InvalidateContents  (WBAM_Dummy+7)         // (BPTR) Invalidate contents for all windows.
+#define WBAM_OpenDrawer          (WBAM_Dummy+8)         // (BPTR) Open (or bring to front) the window for a drawer, in Task context.
+#define WBAM_OpenSelected        (WBAM_Dummy+9)         // Open all selected items on the next IntuiTick (safe from Input context).
+#define WBAM_Launch              (WBAM_Dummy+10)        // (BPTR, CONST_STRPTR) Queue a tool or project for the launcher processes.
+#define WBAM_QueueJob            (WBAM_Dummy+11)        // (ULONG, BPTR, CONST_STRPTR, struct TagItem *, LONG, LONG) Queue a background file operation.
+#define WBAM_BackdropResolved    (WBAM_Dummy+12)        // (BPTR) A .backdrop entry has been locked: show it in the root window, and not in its drawer.
 
 struct wbam_ForSelected {
     STACKED ULONG             MethodID;
@@ -51,6 +58,32 @@ struct wbam_InvalidateContents {
     STACKED BPTR  wbami_VolumeLock;
 };
 
+struct wbam_OpenDrawer {
+    STACKED ULONG MethodID;
+    STACKED BPTR  wbamo_Lock;      // Lock of the drawer or volume. Not consumed.
+};
+
+struct wbam_Launch {
+    STACKED ULONG MethodID;
+    STACKED BPTR  wbaml_Lock;      // Lock of the parent directory. Not consumed.
+    STACKED CONST_STRPTR wbaml_File;
+};
+
+struct wbam_QueueJob {
+    STACKED ULONG MethodID;
+    STACKED ULONG wbamq_Type;      // WBJOB_* from wbworker.h
+    STACKED BPTR  wbamq_Lock;      // Target directory. Not consumed.
+    STACKED CONST_STRPTR wbamq_File;   // WBJOB_COPY, WBJOB_DELETE. Copied.
+    STACKED struct TagItem *wbamq_Args; // WBJOB_DROP. Copied.
+    STACKED LONG  wbamq_TargetX;
+    STACKED LONG  wbamq_TargetY;
+};
+
+struct wbam_BackdropResolved {
+    STACKED ULONG MethodID;
+    STACKED BPTR  wbambr_Lock;     // Lock of the entry. Not consumed.
+};
+
 Class *WBApp_MakeClass(struct WorkbookBase *wb);
 
 #define WBApp        wb->wb_WBApp
@@ -88,6 +121,8 @@ Class *WBApp_MakeClass(struct WorkbookBase *wb);
 #define WBWM_CacheContents       (WBWM_Dummy+8)  /* N/A */
 #define WBWM_ReportSelected      (WBWM_Dummy+9)  /* struct wbwm_ReportSelected */
 #define WBWM_Front               (WBWM_Dummy+10) // N/A
+#define WBWM_UpdateFile          (WBWM_Dummy+11) // (CONST_STRPTR) Reload (or add, or remove) the icon for a single file.
+#define WBWM_Shed                (WBWM_Dummy+12) // N/A. WBIM_Shed all icons not in view, to be restored as they come into view. Returns the number shed.
 
 struct wbwm_MenuPick {
     STACKED ULONG             MethodID;
@@ -110,6 +145,11 @@ struct wbwm_InvalidateContents {
     STACKED BPTR wbwmi_VolumeLock;
 };
 
+struct wbwm_UpdateFile {
+    STACKED ULONG             MethodID;
+    STACKED CONST_STRPTR      wbwmu_File;   // FilePart() of the file (or its .info) in this drawer.
+};
+
 Class *WBWindow_MakeClass(struct WorkbookBase *wb);
 
 #define WBWindow        wb->wb_WBWindow
@@ -146,6 +186,7 @@ Class *WBVirtual_MakeClass(struct WorkbookBase *wb);
 #define WBSA_Dummy               (TAG_USER | 0x40430000)
 #define WBSA_ViewModes          (WBSA_Dummy + 0) // (UWORD) A 'DrawerData->dd_ViewModes' value
 #define WBSA_Backdrop           (WBSA_Dummy + 1) // (BOOL) Is this the Backdrop set?
+#define WBSA_Members            (WBSA_Dummy + 2) // (struct List *) [OM_GET] Members, as struct wbSetNode. Read only.
 
 /* Methods */
 #define WBSM_Dummy               (TAG_USER | 0x40430100)
@@ -164,6 +205,17 @@ struct wbsm_CleanUp {
     STACKED struct GadgetInfo	*wbscu_GInfo;	/* gadget context		*/
 };
 
+/* Membership of an icon in a WBSet. This is part of the icon's instance
+ * data (see WBIA_SetNode), so the set needs no allocation per member.
+ */
+struct wbSetNode {
+    struct Node sn_Node;        // ln_Name is the icon's label.
+    Object        *sn_Object;      // Gadget object
+    BOOL           sn_Backdrop;    // Is the backdrop set?
+    LONG           sn_CurrentX;    // do_CurrentX cache.
+    LONG           sn_CurrentY;    // do_CurrentY cache.
+};
+
 
 Class *WBSet_MakeClass(struct WorkbookBase *wb);
 
@@ -184,6 +236,8 @@ Class *WBSet_MakeClass(struct WorkbookBase *wb);
  *    WBIA_File         (CONST_STRPTR) FilePart() of filename
  *    WBIA_Label        (CONST_STRPTR) label to display [optional]
  *    WBIA_ParentLock   (BPTR) lock to containing drawer/volume
+ *      or
+ *    WBIA_ParentShare  (struct wbSharedLock *) of the containing drawer/volume
  */
 
 /* Attributes */
@@ -195,6 +249,10 @@ Class *WBSet_MakeClass(struct WorkbookBase *wb);
 #define WBIA_ListView            (WBIA_Dummy+4)        // (BOOL) [OM_NEW, OM_SET] List, not icon, rendering.
 #define WBIA_ListLabelWidth      (WBIA_Dummy+5)        // (ULONG) [OM_NEW, OM_SET] Label width, in characters.
 #define WBIA_HitBox              (WBIA_Dummy+6)        // (struct Rectangle) [OM_GET] Icon hit box
+#define WBIA_Pool                (WBIA_Dummy+7)        // (APTR) [OM_NEW] Memory pool for the icon's list view data, which must outlive it [optional]
+#define WBIA_SetNode             (WBIA_Dummy+8)        // (struct wbSetNode *) [OM_GET] The icon's node for its WBSet.
+#define WBIA_ParentShare         (WBIA_Dummy+9)        // (struct wbSharedLock *) [OM_NEW] Shared lock to containing drawer/volume, overriding WBIA_ParentLock. A reference is taken; icons never outlive their window, which disposes them before its pool.
+#define WBIA_Strings             (WBIA_Dummy+10)       // (struct wbStringTable *) [OM_NEW] Table to intern File and Label in, which must outlive the icon [optional]
 #define WBIA_FibProtection       (WBIA_Dummy+16)       // (ULONG) [OM_GET] FileInfoBlock->fib_Protection of the file.
 #define WBIA_FibSize             (WBIA_Dummy+17)       // (ULONG) [OM_GET] FileInfoBlock->fib_Size of the file.
 #define WBIA_FibDateStamp        (WBIA_Dummy+19)       // (struct DateStamp *) [OM_GET] FileInfoBlock->fib_DateStamp of the file.
@@ -202,10 +260,12 @@ Class *WBSet_MakeClass(struct WorkbookBase *wb);
 #define WBIA_DoCurrentX          (WBIA_Dummy+35)       // (LONG) [OM_SET,OM_GET] DiskObject->do_CurrentX
 #define WBIA_DoCurrentY          (WBIA_Dummy+36)       // (LONG) [OM_SET,OM_GET] DiskObject->do_CurrentY
 #define WBIA_Backdrop            (WBIA_Dummy+37)       // (BOOL) [OM_SET,OM_GET] Is this a backdrop icon?
+#define WBIA_BackdropLock        (WBIA_Dummy+38)       // (BPTR) [OM_GET] Lock on a backdrop icon's file, or BNULL. Owned by the icon.
+#define WBIA_BackdropKey         (WBIA_Dummy+39)       // (ULONG) [OM_NEW, OM_GET] wbBackdropHash() of the file's volume relative path, if already known [optional]. 0 for volumes.
 
 /* Methods */
 #define WBIM_Dummy               (TAG_USER | 0x40440100)
-#define WBIM_Open                (WBIM_Dummy + 0)        // NA
+#define WBIM_Open                (WBIM_Dummy + 0)        // NA, in Task context.
 #define WBIM_Copy                (WBIM_Dummy + 1)        // NA
 #define WBIM_Rename              (WBIM_Dummy + 2)        // NA
 #define WBIM_Info                (WBIM_Dummy + 3)        // NA
@@ -218,6 +278,8 @@ Class *WBSet_MakeClass(struct WorkbookBase *wb);
 #define WBIM_Empty_Trash         (WBIM_Dummy + 10)       // NA
 #define WBIM_DragDropAdd         (WBIM_Dummy + 11)       // (GadgetInfo *, Object *WBDragDrop) use WBDM_Add to add icon imagery
 #define WBIM_MoveBy              (WBIM_Dummy + 12)       // (GadgetInfo *, LONG deltaX, LONG deltaY)
+#define WBIM_Shed                (WBIM_Dummy + 13)       // NA, in Task context. Free imagery that WBIM_Reload can rebuild. Returns TRUE if anything was freed.
+#define WBIM_Reload              (WBIM_Dummy + 14)       // NA, in Task context. Rebuild shed imagery for the current view. Returns TRUE if the icon needs drawing.
 
 /* Return flags for all WBIM_ methods */
 #define WBIF_OK                 (0)        // Window imagery unchanged.
@@ -305,18 +367,40 @@ struct wbxm_DragDropped {
 //
 // OM_NEW, OM_DISPOSE
 #define WBBM_Dummy              (TAG_USER | 0x40450100)
-#define WBBM_LockIs             (WBBM_Dummy + 0)    // (BPTR) Is lock a backdrop for any managed volume?
-#define WBBM_LockNext           (WBBM_Dummy + 1)    // (BPTR) -> (BPTR) Get the next lock (start with BNULL)
+#define WBBM_LockIs             (WBBM_Dummy + 0)    // (BPTR, ULONG key) Is lock a backdrop for any managed volume?
+#define WBBM_LockNext           (WBBM_Dummy + 1)    // (struct wbbm_Cursor *) -> (BPTR) Get the next resolved lock, or BNULL at the end.
 #define WBBM_LockAdd            (WBBM_Dummy + 2)    // (BPTR) Add file for a lock to the backdrop for its volume.
-#define WBBM_LockDel            (WBBM_Dummy + 3)    // (BPTR) Del file for a lock from the backdrop for its volume.
+#define WBBM_LockDel            (WBBM_Dummy + 3)    // (BPTR, ULONG key) Del file for a lock from the backdrop for its volume.
 #define WBBM_VolumeAdd          (WBBM_Dummy + 4)    // (BPTR) Manage .backdrop entries for a volume.
 #define WBBM_VolumeDel          (WBBM_Dummy + 5)    // (BPTR) Stop managing .backdrop entries for a volume.
+#define WBBM_Flush              (WBBM_Dummy + 6)    // () Write out the .backdrop of every changed volume.
+#define WBBM_Prune              (WBBM_Dummy + 7)    // () -> (BOOL) Lock a few pending entries, dropping stale ones and sending WBAM_BackdropResolved for the rest. TRUE if any remain.
 
 struct wbbm_Lock {
     STACKED ULONG MethodID;
     STACKED BPTR  wbbml_Lock;
 };
 
+// For WBBM_LockIs and WBBM_LockDel. The key is the wbBackdropHash() of the
+// lock's volume relative path, and only entries with that key are compared.
+struct wbbm_LockKey {
+    STACKED ULONG MethodID;
+    STACKED BPTR  wbbmlk_Lock;
+    STACKED ULONG wbbmlk_Key;
+};
+
+// Position of a WBBM_LockNext walk. Clear it to start from the first lock.
+struct wbbm_Cursor {
+    APTR  wbbmc_Volume;
+    APTR  wbbmc_Entry;
+    ULONG wbbmc_Key;    // Key of the lock returned by WBBM_LockNext.
+};
+
+struct wbbm_LockNext {
+    STACKED ULONG MethodID;
+    STACKED struct wbbm_Cursor *wbbmln_Cursor;
+};
+
 Class *WBBackdrop_MakeClass(struct WorkbookBase *wb);
 
 #define WBBackdrop  wb->wb_WBBackdrop
@@ -4,6 +4,7 @@
     Desc: Workbook Application Class
 */
 
+#include <stdio.h>
 #include <string.h>
 #include <limits.h>
 
@@ -16,6 +17,9 @@
 #include <proto/layers.h>
 
 #include <dos/dostags.h>
+#include <devices/timer.h>
+#include <exec/interrupts.h>
+#include <exec/memory.h>
 #include <intuition/classusr.h>
 #include <intuition/intuition.h>
 #include <libraries/gadtools.h>
@@ -24,6 +28,8 @@
 #include "workbook_menu.h"
 #include "classes.h"
 #include "wbcurrent.h"
+#include "wblauncher.h"
+#include "wbworker.h"
 
 struct wbApp {
     struct Screen  *Screen;
@@ -33,9 +39,11 @@ struct wbApp {
     ULONG           AppMask;   /* Mask of our port(s) */
     struct MsgPort *NotifyPort;
     ULONG           NotifyMask;   /* Mask of our port(s) */
+    struct MsgPort *JobPort;
+    ULONG           JobMask;   /* Mask of our port(s) */
     Object         *Root;      /* Background 'root' window */
 
-    struct MinList  Windows; /* Subwindows */
+    struct MinList  Windows; /* Subwindows, least recently active first */
     BOOL CacheForced;
 
     // Execute... command buffer
@@ -45,28 +53,65 @@ struct wbApp {
     Object *DragDrop;
     BOOL    DragDropActive;
 
+    // Tool and project launcher processes (may be NULL)
+    struct wbLauncher *Launcher;
+
+    // Background file operations
+    struct wbWorker *Worker;   /* May be NULL */
+    struct MinList   Jobs;     /* Queued and running jobs */
+    TEXT             JobStatus[128];
+    ULONG            CopyFlags; /* WBCOPYF_* for new jobs */
+
     // On-intitick actions
     struct {
         BOOL DragDrop;
+        BOOL Open;
     } OnIntuiTick;
+
+    // .backdrop upkeep once things go quiet. IntuiTicks only come
+    // while one of our windows is active, so they can't be relied on.
+    struct {
+        struct MsgPort     *Port;
+        struct timerequest *Request;   /* NULL if timer.device couldn't be opened */
+        ULONG               Mask;
+        BOOL                Pending;   /* Request is with timer.device */
+    } Idle;
+
+    // Low memory handling
+    struct {
+        struct Interrupt Handler;
+        struct Task     *Task;
+        BYTE             SigBit;    /* -1 if no handler is installed */
+        ULONG            Mask;
+        ULONG            Request;   /* Largest failed allocation since the last shed */
+    } LowMem;
 };
 
-static void wbOpenDrawer(Class *cl, Object *obj, CONST_STRPTR path)
+// Exec low memory handler. This runs in the context of whichever task's
+// allocation failed, possibly under Forbid(), so all it can do is
+// ask the Workbook process to shed what it can.
+static AROS_UFH3(LONG, wbAppLowMemHandler,
+    AROS_UFHA(struct MemHandlerData *, mhd, A0),
+    AROS_UFHA(struct wbApp *, my, A1),
+    AROS_UFHA(struct ExecBase *, SysBase, A6))
 {
-    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
-    struct wbApp *my = INST_DATA(cl, obj);
-    Object *win;
-
-    ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
+    AROS_USERFUNC_INIT
 
-    BPTR lock = BNULL;
-    if (path != NULL) {
-        lock = Lock(path, SHARED_LOCK);
-        if (lock == BNULL) {
-            return;
-        }
+    if (mhd->memh_RequestSize > my->LowMem.Request) {
+        my->LowMem.Request = mhd->memh_RequestSize;
     }
+    Signal(my->LowMem.Task, my->LowMem.Mask);
+
+    return MEM_DID_NOTHING;
 
+    AROS_USERFUNC_EXIT
+}
+
+// Find the WBWindow object showing the drawer for a lock.
+static Object *wbLookupDrawer(Class *cl, Object *obj, BPTR lock)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbApp *my = INST_DATA(cl, obj);
     Object *ostate = (Object *)my->Windows.mlh_Head;
     Object *owin;
 
@@ -78,6 +123,19 @@ static void wbOpenDrawer(Class *cl, Object *obj, CONST_STRPTR path)
         }
     }
 
+    return owin;
+}
+
+static void wbOpenDrawerLock(Class *cl, Object *obj, BPTR lock)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbApp *my = INST_DATA(cl, obj);
+    Object *win;
+
+    ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
+
+    Object *owin = wbLookupDrawer(cl, obj, lock);
+
     if (owin == NULL) {
         win = NewObject(WBWindow, NULL,
                             WBWA_Lock, lock,
@@ -93,12 +151,76 @@ static void wbOpenDrawer(Class *cl, Object *obj, CONST_STRPTR path)
     } else {
         DoMethod(owin, WBWM_Front);
     }
+}
+
+static void wbOpenDrawer(Class *cl, Object *obj, CONST_STRPTR path)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+
+    ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
+
+    BPTR lock = BNULL;
+    if (path != NULL) {
+        lock = Lock(path, SHARED_LOCK);
+        if (lock == BNULL) {
+            return;
+        }
+    }
+
+    wbOpenDrawerLock(cl, obj, lock);
 
     if (lock != BNULL) {
         UnLock(lock);
     }
 }
 
+// Refresh the single object named by a WBHM_TYPE_UPDATE message.
+//
+// Only the window showing the object's drawer is touched, and that
+// window only reloads the one icon (see WBWM_UpdateFile).
+static void wbUpdateObject(Class *cl, Object *obj, CONST_STRPTR name)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbApp *my = INST_DATA(cl, obj);
+
+    ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
+
+    if (name == NULL || name[0] == 0) {
+        return;
+    }
+
+    D(bug("%s: Update '%s'\n", __func__, name));
+
+    if (name[STRLEN(name)-1] == ':') {
+        // Volumes only live in the root window.
+        DoMethod(my->Root, WBWM_UpdateFile, name);
+        return;
+    }
+
+    // Lock the drawer containing the object.
+    IPTR dir_len = PathPart(name) - name;
+    STRPTR dir = AllocVec(dir_len + 1, MEMF_ANY);
+    if (dir == NULL) {
+        return;
+    }
+    CopyMem(name, dir, dir_len);
+    dir[dir_len] = 0;
+
+    BPTR lock = Lock(dir, SHARED_LOCK);
+    FreeVec(dir);
+    if (lock == BNULL) {
+        D(bug("%s: No drawer for '%s'\n", __func__, name));
+        return;
+    }
+
+    Object *owin = wbLookupDrawer(cl, obj, lock);
+    UnLock(lock);
+
+    if (owin != NULL) {
+        DoMethod(owin, WBWM_UpdateFile, FilePart(name));
+    }
+}
+
 static struct Window *wbAppWindowAt(Class *cl, Object *obj, struct Screen *screen) {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
     struct Layer *layer = NULL;
@@ -114,6 +236,266 @@ static struct Window *wbAppWindowAt(Class *cl, Object *obj, struct Screen *scree
     return NULL;
 }
 
+// Refresh the window (if any) showing a drawer that a job has changed.
+static void wbAppJobInvalidate(Class *cl, Object *obj, BPTR lock)
+{
+    struct wbApp *my = INST_DATA(cl, obj);
+    Object *owin;
+
+    if (lock == BNULL) {
+        return;
+    }
+
+    owin = wbLookupDrawer(cl, obj, lock);
+    if (owin) {
+        DoMethod(owin, WBWM_InvalidateContents, (IPTR)BNULL);
+        my->CacheForced = TRUE;
+    }
+}
+
+// Update the status text for the queued and running jobs.
+static void wbAppJobsStatus(Class *cl, Object *obj)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbApp *my = INST_DATA(cl, obj);
+    struct MinNode *node;
+    struct wbJob *active = NULL;
+    ULONG queued = 0;
+
+    ForeachNode(&my->Jobs, node) {
+        struct wbJob *job = wbJobFromNode(node);
+        if (active == NULL && job->wj_Active) {
+            active = job;
+        } else {
+            queued++;
+        }
+    }
+
+    TEXT more[32] = "";
+    if (queued > 0) {
+        snprintf(more, sizeof(more), " (%lu more)", (unsigned long)queued);
+        more[sizeof(more)-1] = 0;
+    }
+
+    if (active == NULL) {
+        snprintf(my->JobStatus, sizeof(my->JobStatus), "Waiting...%s", more);
+    } else {
+        CONST_STRPTR verb;
+        switch (active->wj_Type) {
+        case WBJOB_COPY:   verb = "Copying"; break;
+        case WBJOB_DELETE: verb = "Deleting"; break;
+        default:           verb = "Transferring"; break;
+        }
+
+        // Throughput since the job started.
+        struct DateStamp now;
+        DateStamp(&now);
+        LONG ticks = ((now.ds_Days - active->wj_Start.ds_Days) * 24 * 60 +
+                      (now.ds_Minute - active->wj_Start.ds_Minute)) * 60 * TICKS_PER_SECOND +
+                     (now.ds_Tick - active->wj_Start.ds_Tick);
+        ULONG kbytes = active->wj_Progress.wp_Bytes / 1024;
+        ULONG rate = (ticks >= TICKS_PER_SECOND) ? (kbytes * TICKS_PER_SECOND / ticks) : 0;
+
+        TEXT verified[32] = "";
+        if (active->wj_Progress.wp_Flags & WBCOPYF_VERIFY) {
+            snprintf(verified, sizeof(verified), " (%lu verified)", (unsigned long)active->wj_Progress.wp_Verified);
+            verified[sizeof(verified)-1] = 0;
+        }
+
+        snprintf(my->JobStatus, sizeof(my->JobStatus), "%s%s%s: %lu files%s, %luK, %luK/s%s",
+                 verb,
+                 active->wj_File ? " " : "",
+                 active->wj_File ? (CONST_STRPTR)active->wj_File : "",
+                 (unsigned long)active->wj_Progress.wp_Files,
+                 verified,
+                 (unsigned long)kbytes,
+                 (unsigned long)rate,
+                 more);
+    }
+    my->JobStatus[sizeof(my->JobStatus)-1] = 0;
+}
+
+// Ask all queued and running jobs to stop.
+static void wbAppJobsCancel(Class *cl, Object *obj)
+{
+    struct wbApp *my = INST_DATA(cl, obj);
+    struct MinNode *node;
+
+    ForeachNode(&my->Jobs, node) {
+        wbJobFromNode(node)->wj_Progress.wp_Cancel = TRUE;
+    }
+}
+
+// Set or clear a copy option, and check its menu item in every window.
+static void wbAppCopyOption(Class *cl, Object *obj, ULONG menuNumber, ULONG flag, BOOL set)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbApp *my = INST_DATA(cl, obj);
+    Object *ostate = (Object *)my->Windows.mlh_Head;
+    Object *owin;
+
+    if (set) {
+        my->CopyFlags |= flag;
+    } else {
+        my->CopyFlags &= ~flag;
+    }
+
+    while ((owin = NextObject(&ostate))) {
+        struct Window *win = NULL;
+        GetAttr(WBWA_Window, owin, (IPTR *)&win);
+        if (win == NULL || win->MenuStrip == NULL) {
+            continue;
+        }
+        struct Menu *menu = win->MenuStrip;
+        ClearMenuStrip(win);
+        struct MenuItem *item = ItemAddress(menu, menuNumber);
+        if (item) {
+            if (set) {
+                item->Flags |= CHECKED;
+            } else {
+                item->Flags &= ~CHECKED;
+            }
+        }
+        ResetMenuStrip(win, menu);
+    }
+}
+
+// A job has been replied by the worker.
+static void wbAppJobDone(Class *cl, Object *obj, struct wbJob *job)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+
+    RemoveMinNode(&job->wj_Node);
+
+    wbAppJobInvalidate(cl, obj, job->wj_Dir);
+    if (job->wj_Args != NULL) {
+        // Moves also change the source drawers.
+        struct TagItem *tstate = job->wj_Args;
+        struct TagItem *ti;
+        while ((ti = NextTagItem(&tstate)) != NULL) {
+            if (ti->ti_Tag == WBOPENA_ArgLock) {
+                wbAppJobInvalidate(cl, obj, (BPTR)ti->ti_Data);
+            }
+        }
+    }
+
+    // Files that did not verify were deleted, whatever else went wrong.
+    if (job->wj_Progress.wp_Mismatched > 0) {
+        struct EasyStruct es = {
+            .es_StructSize = sizeof(es),
+            .es_Title = (STRPTR)"Verify",
+            .es_TextFormat = (STRPTR)"%lu of %lu copied files did not match\ntheir source, and were deleted.",
+            .es_GadgetFormat = (STRPTR)"Ok",
+        };
+        EasyRequest(NULL, &es, NULL,
+                    (IPTR)job->wj_Progress.wp_Mismatched,
+                    (IPTR)(job->wj_Progress.wp_Mismatched + job->wj_Progress.wp_Verified));
+    } else if (!job->wj_Ok && job->wj_Error != ERROR_BREAK) {
+        // Don't complain about jobs the user cancelled.
+        switch (job->wj_Type) {
+        case WBJOB_COPY:
+            wbPopupIoErr(wb, "Copy", job->wj_Error, job->wj_File);
+            break;
+        case WBJOB_DELETE:
+            wbPopupIoErr(wb, "Delete", job->wj_Error, job->wj_File);
+            break;
+        default:
+            {
+                // Name the first item that failed, and count the rest.
+                CONST_STRPTR name = NULL;
+                ULONG failed = 0;
+                ULONG index = 0;
+                struct TagItem *tstate = job->wj_Args;
+                struct TagItem *ti;
+                while ((ti = NextTagItem(&tstate)) != NULL) {
+                    if (ti->ti_Tag != WBOPENA_ArgName) {
+                        continue;
+                    }
+                    LONG err = job->wj_Errors ? job->wj_Errors[index] : 0;
+                    if (err != 0 && err != ERROR_BREAK) {
+                        if (name == NULL) {
+                            name = (CONST_STRPTR)ti->ti_Data;
+                        }
+                        failed++;
+                    }
+                    index++;
+                }
+
+                if (name != NULL) {
+                    TEXT prefix[FILENAME_MAX];
+                    if (failed > 1) {
+                        snprintf(prefix, sizeof(prefix), "%s (and %lu more)", name, (unsigned long)(failed - 1));
+                    } else {
+                        snprintf(prefix, sizeof(prefix), "%s", name);
+                    }
+                    wbPopupIoErr(wb, "Drawer Drag/Drop", job->wj_Error, prefix);
+                } else {
+                    STRPTR path = wbAbspathLock(job->wj_Dir);
+                    wbPopupIoErr(wb, "Drawer Drag/Drop", job->wj_Error, path ? path : (STRPTR)"");
+                    FreeVec(path);
+                }
+            }
+            break;
+        }
+    }
+
+    wbJobFree(job);
+}
+
+// Seconds of quiet before the idle timer does .backdrop upkeep.
+#define WBAPP_IDLE_SECS     2
+// Microseconds between rounds of WBBM_Prune, while entries are pending.
+#define WBAPP_PRUNE_MICROS  100000
+
+static void wbAppIdleOpen(struct wbApp *my)
+{
+    my->Idle.Port = CreateMsgPort();
+    if (my->Idle.Port != NULL) {
+        my->Idle.Request = (struct timerequest *)CreateIORequest(my->Idle.Port, sizeof(struct timerequest));
+        if (my->Idle.Request != NULL && OpenDevice(TIMERNAME, UNIT_VBLANK, &my->Idle.Request->tr_node, 0) != 0) {
+            DeleteIORequest(&my->Idle.Request->tr_node);
+            my->Idle.Request = NULL;
+        }
+        if (my->Idle.Request == NULL) {
+            DeleteMsgPort(my->Idle.Port);
+            my->Idle.Port = NULL;
+        }
+    }
+
+    my->Idle.Mask = (my->Idle.Port != NULL) ? (1UL << my->Idle.Port->mp_SigBit) : 0;
+    my->Idle.Pending = FALSE;
+}
+
+static void wbAppIdleClose(struct wbApp *my)
+{
+    if (my->Idle.Request == NULL) {
+        return;
+    }
+
+    if (my->Idle.Pending) {
+        AbortIO(&my->Idle.Request->tr_node);
+        WaitIO(&my->Idle.Request->tr_node);
+    }
+    CloseDevice(&my->Idle.Request->tr_node);
+    DeleteIORequest(&my->Idle.Request->tr_node);
+    DeleteMsgPort(my->Idle.Port);
+}
+
+// (Re)start the idle timer, unless it is already running.
+// With 'soon', only wait long enough to let other events through.
+static void wbAppIdleStart(struct wbApp *my, BOOL soon)
+{
+    if (my->Idle.Request == NULL || my->Idle.Pending) {
+        return;
+    }
+
+    my->Idle.Request->tr_node.io_Command = TR_ADDREQUEST;
+    my->Idle.Request->tr_time.tv_secs = soon ? 0 : WBAPP_IDLE_SECS;
+    my->Idle.Request->tr_time.tv_micro = soon ? WBAPP_PRUNE_MICROS : 0;
+    SendIO(&my->Idle.Request->tr_node);
+    my->Idle.Pending = TRUE;
+}
+
 // OM_NEW
 static IPTR WBApp__OM_NEW(Class *cl, Object *obj, struct opSet *ops)
 {
@@ -134,6 +516,7 @@ static IPTR WBApp__OM_NEW(Class *cl, Object *obj, struct opSet *ops)
     my = INST_DATA(cl, rc);
 
     NEWLIST(&my->Windows);
+    NEWLIST(&my->Jobs);
 
     // Set our screen.
     my->Screen = screen;
@@ -165,13 +548,26 @@ static IPTR WBApp__OM_NEW(Class *cl, Object *obj, struct opSet *ops)
         return 0;
     }
 
+    /* Create our Job message port */
+    my->JobPort = CreatePort(NULL, 0);
+
+    if (my->JobPort == NULL) {
+        DeleteMsgPort(my->NotifyPort);
+        DeleteMsgPort(my->WinPort);
+        DeleteMsgPort(my->AppPort);
+        DoSuperMethod(cl, (Object *)rc, OM_DISPOSE);
+        return 0;
+    }
+
     my->AppMask |= (1UL << my->AppPort->mp_SigBit);
     my->WinMask |= (1UL << my->WinPort->mp_SigBit);
     my->NotifyMask |= (1UL << my->NotifyPort->mp_SigBit);
+    my->JobMask |= (1UL << my->JobPort->mp_SigBit);
 
     // Initialize our DragDrop information
     my->DragDrop = NewObject(WBDragDrop, NULL, WBDA_Screen, my->Screen, TAG_END);
     if (my->DragDrop == NULL) {
+        DeleteMsgPort(my->JobPort);
         DeleteMsgPort(my->NotifyPort);
         DeleteMsgPort(my->WinPort);
         DeleteMsgPort(my->AppPort);
@@ -188,6 +584,7 @@ static IPTR WBApp__OM_NEW(Class *cl, Object *obj, struct opSet *ops)
                          TAG_END);
     if (my->Root == NULL) {
         DisposeObject(my->DragDrop);
+        DeleteMsgPort(my->JobPort);
         DeleteMsgPort(my->NotifyPort);
         DeleteMsgPort(my->WinPort);
         DeleteMsgPort(my->AppPort);
@@ -197,6 +594,30 @@ static IPTR WBApp__OM_NEW(Class *cl, Object *obj, struct opSet *ops)
 
     my->CacheForced = FALSE;
 
+    // Not fatal if this fails; WBAM_Launch will just return FALSE.
+    my->Launcher = wbLauncherCreate();
+
+    // Not fatal if this fails; WBAM_QueueJob will just return FALSE.
+    my->Worker = wbWorkerCreate(my->JobPort);
+
+    // Not fatal if this fails; .backdrop changes are then only written
+    // out on menu picks and IntuiTicks.
+    wbAppIdleOpen(my);
+
+    // Not fatal if this fails; we just won't shed imagery under low memory.
+    my->LowMem.SigBit = AllocSignal(-1);
+    if (my->LowMem.SigBit != -1) {
+        my->LowMem.Task = FindTask(NULL);
+        my->LowMem.Mask = 1UL << my->LowMem.SigBit;
+        my->LowMem.Request = 0;
+        my->LowMem.Handler.is_Node.ln_Type = NT_INTERRUPT;
+        my->LowMem.Handler.is_Node.ln_Pri = 0;
+        my->LowMem.Handler.is_Node.ln_Name = "Workbook";
+        my->LowMem.Handler.is_Data = my;
+        my->LowMem.Handler.is_Code = (VOID_FUNC)wbAppLowMemHandler;
+        AddMemHandler(&my->LowMem.Handler);
+    }
+
     DoMethod(my->Root, OM_ADDTAIL, &my->Windows);
 
     return rc;
@@ -221,6 +642,25 @@ static IPTR WBApp__OM_DISPOSE(Class *cl, Object *obj, Msg msg)
     // Get rid of the DragDrop manager
     DisposeObject(my->DragDrop);
 
+    // Wait for any pending launches.
+    wbLauncherDelete(my->Launcher);
+
+    // Stop any file operations, and wait for the worker to finish up.
+    struct wbJob *job;
+    wbAppJobsCancel(cl, obj);
+    wbWorkerDelete(my->Worker);
+    while ((job = (struct wbJob *)GetMsg(my->JobPort)) != NULL) {
+        wbJobFree(job);
+    }
+
+    if (my->LowMem.SigBit != -1) {
+        RemMemHandler(&my->LowMem.Handler);
+        FreeSignal(my->LowMem.SigBit);
+    }
+
+    wbAppIdleClose(my);
+
+    DeleteMsgPort(my->JobPort);
     DeleteMsgPort(my->NotifyPort);
     DeleteMsgPort(my->AppPort);
     DeleteMsgPort(my->WinPort);
@@ -236,6 +676,12 @@ static IPTR WBApp__OM_GET(Class *cl, Object *obj, struct opGet *opg) {
     case WBAA_Screen:
         *(opg->opg_Storage) = (IPTR)my->Screen;
         break;
+    case WBAA_Status:
+        *(opg->opg_Storage) = (GetHead((struct List *)&my->Jobs) != NULL) ? (IPTR)my->JobStatus : (IPTR)NULL;
+        break;
+    case WBAA_CopyFlags:
+        *(opg->opg_Storage) = (IPTR)my->CopyFlags;
+        break;
     default:
         return FALSE;
     }
@@ -517,6 +963,18 @@ static BOOL wbMenuPick(Class *cl, Object *obj, struct Window *win, UWORD menuNum
             case WBMENU_ID(WBMENU_WB_ABOUT):
                 wbAbout(cl, obj, win);
                 break;
+            case WBMENU_ID(WBMENU_WB_CANCEL):
+                wbAppJobsCancel(cl, obj);
+                break;
+            case WBMENU_ID(WBMENU_WB__COPY_SYNC):
+                wbAppCopyOption(cl, obj, menuNumber, WBCOPYF_SYNC, (item->Flags & CHECKED) ? TRUE : FALSE);
+                break;
+            case WBMENU_ID(WBMENU_WB__COPY_VERIFY):
+                wbAppCopyOption(cl, obj, menuNumber, WBCOPYF_VERIFY, (item->Flags & CHECKED) ? TRUE : FALSE);
+                break;
+            case WBMENU_ID(WBMENU_WB__COPY_MOVE):
+                wbAppCopyOption(cl, obj, menuNumber, WBCOPYF_MOVE, (item->Flags & CHECKED) ? TRUE : FALSE);
+                break;
             case WBMENU_ID(WBMENU_WB_EXECUTE):
                 wbPopupAction(wb, "Execute a file",
                                   "Enter Command and its Arguments",
@@ -581,6 +1039,9 @@ static BOOL wbMenuPick(Class *cl, Object *obj, struct Window *win, UWORD menuNum
         menuNumber = item->NextSelect;
     }
 
+    // Write out any .backdrop changes, once for all of the picks.
+    DoMethod(wb->wb_Backdrop, WBBM_Flush);
+
     return quit;
 }
 
@@ -650,6 +1111,21 @@ static void wbAppIntuiTick(Class *cl, Object *obj, struct Window *win)
          }
     }
 
+    if (my->OnIntuiTick.Open) {
+        my->OnIntuiTick.Open = FALSE;
+        wbAppForSelected(cl, obj, WBIM_Open);
+        DoMethod(obj, WBAM_ClearSelected);
+    }
+
+    if (GetHead((struct List *)&my->Jobs) != NULL) {
+        wbAppJobsStatus(cl, obj);
+    }
+
+    // Drop stale .backdrop entries while idle, then write out
+    // anything that changed .backdrop outside of a menu pick.
+    DoMethod(wb->wb_Backdrop, WBBM_Prune);
+    DoMethod(wb->wb_Backdrop, WBBM_Flush);
+
     // Set if we invalidated anything.
     if (my->CacheForced) {
         wbAppForAllWindows(cl, obj, WBWM_CacheContents);
@@ -658,7 +1134,40 @@ static void wbAppIntuiTick(Class *cl, Object *obj, struct Window *win)
 
     if ((owin = wbLookupWindow(cl, obj, win))) {
         DoMethod(owin, WBWM_IntuiTick);
+
+        // Only the active window gets ticks, so this keeps the
+        // window list in least recently active order.
+        DoMethod(owin, OM_REMOVE);
+        DoMethod(owin, OM_ADDTAIL, &my->Windows);
+    }
+}
+
+// Shed icon imagery from the least recently active windows first,
+// until the failed allocation would fit.
+static void wbAppLowMemory(Class *cl, Object *obj)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbApp *my = INST_DATA(cl, obj);
+    Object *ostate = (Object *)my->Windows.mlh_Head;
+    Object *owin;
+
+    Forbid();
+    ULONG request = my->LowMem.Request;
+    my->LowMem.Request = 0;
+    Permit();
+
+    D(ULONG before = AvailMem(MEMF_ANY));
+    ULONG shed = 0;
+
+    while ((owin = NextObject(&ostate))) {
+        shed += DoMethod(owin, WBWM_Shed);
+        if (AvailMem(MEMF_ANY | MEMF_LARGEST) > request) {
+            break;
+        }
     }
+
+    D(bug("%s: Request of %ld bytes: shed %ld icons, reclaiming %ld bytes\n", __func__,
+                request, shed, (LONG)(AvailMem(MEMF_ANY) - before)));
 }
 
 static void wbHideAllWindows(Class *cl, Object *obj)
@@ -696,10 +1205,13 @@ static IPTR WBApp__WBAM_Workbench(Class *cl, Object *obj, Msg msg)
     CurrentDir(BNULL);
 
     if (RegisterWorkbench(my->AppPort)) {
+        // Start locking the .backdrop entries of the volumes.
+        wbAppIdleStart(my, TRUE);
+
         while (!done) {
             ULONG mask;
 
-            mask = Wait(my->AppMask | my->WinMask | my->NotifyMask);
+            mask = Wait(my->AppMask | my->WinMask | my->NotifyMask | my->JobMask | my->LowMem.Mask | my->Idle.Mask);
 
             if (mask & my->AppMask) {
                 struct WBHandlerMessage *wbhm;
@@ -720,6 +1232,7 @@ static IPTR WBApp__WBAM_Workbench(Class *cl, Object *obj, Msg msg)
                         break;
                     case WBHM_TYPE_UPDATE:
                         /* Refresh an open window/object */
+                        wbUpdateObject(cl, obj, wbhm->wbhm_Data.Update.Name);
                         break;
                     }
 
@@ -770,6 +1283,43 @@ static IPTR WBApp__WBAM_Workbench(Class *cl, Object *obj, Msg msg)
                 }
             }
 
+            if (mask & my->JobMask) {
+                struct wbJob *job;
+                while ((job = (struct wbJob *)GetMsg(my->JobPort)) != NULL) {
+                    wbAppJobDone(cl, obj, job);
+                }
+                // A finished drop may have left icons out.
+                DoMethod(wb->wb_Backdrop, WBBM_Flush);
+                if (my->CacheForced) {
+                    wbAppForAllWindows(cl, obj, WBWM_CacheContents);
+                    my->CacheForced = FALSE;
+                }
+            }
+
+            if (mask & my->LowMem.Mask) {
+                wbAppLowMemory(cl, obj);
+            }
+
+            if (mask & my->Idle.Mask) {
+                if (GetMsg(my->Idle.Port) != NULL) {
+                    my->Idle.Pending = FALSE;
+                }
+                // Write out what changed, and keep locking pending
+                // .backdrop entries for as long as there are any.
+                BOOL pending = DoMethod(wb->wb_Backdrop, WBBM_Prune);
+                DoMethod(wb->wb_Backdrop, WBBM_Flush);
+                if (my->CacheForced) {
+                    wbAppForAllWindows(cl, obj, WBWM_CacheContents);
+                    my->CacheForced = FALSE;
+                }
+                if (pending) {
+                    wbAppIdleStart(my, TRUE);
+                }
+            } else {
+                // Anything else may have changed .backdrop.
+                wbAppIdleStart(my, FALSE);
+            }
+
          }
 
         wbCloseAllWindows(cl, obj);
@@ -840,6 +1390,89 @@ static IPTR WBApp__WBAM_InvalidateContents(Class *cl, Object *obj, struct wbam_I
     return 0;
 }
 
+static IPTR WBApp__WBAM_OpenDrawer(Class *cl, Object *obj, struct wbam_OpenDrawer *wbamo)
+{
+    wbOpenDrawerLock(cl, obj, wbamo->wbamo_Lock);
+
+    return 0;
+}
+
+// Called from Input context (ie a double-click), so defer the opening
+// to the Workbench process.
+static IPTR WBApp__WBAM_OpenSelected(Class *cl, Object *obj, Msg msg)
+{
+    struct wbApp *my = INST_DATA(cl, obj);
+
+    my->OnIntuiTick.Open = TRUE;
+
+    return 0;
+}
+
+// The root window picks up the new backdrop icon when it is next cached.
+// Its drawer, if open, reloads just that icon, which is now hidden there.
+static IPTR WBApp__WBAM_BackdropResolved(Class *cl, Object *obj, struct wbam_BackdropResolved *wbambr)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbApp *my = INST_DATA(cl, obj);
+    BPTR lock = wbambr->wbambr_Lock;
+
+    DoMethod(my->Root, WBWM_InvalidateContents, (IPTR)BNULL);
+    my->CacheForced = TRUE;
+
+    BPTR parent = ParentDir(lock);
+    if (parent == BNULL) {
+        return 0;
+    }
+
+    Object *owin = wbLookupDrawer(cl, obj, parent);
+    UnLock(parent);
+    if (owin != NULL) {
+        struct FileInfoBlock *fib = AllocDosObject(DOS_FIB, NULL);
+        if (fib != NULL) {
+            if (Examine(lock, fib)) {
+                DoMethod(owin, WBWM_UpdateFile, fib->fib_FileName);
+            }
+            FreeDosObject(DOS_FIB, fib);
+        }
+    }
+
+    return 0;
+}
+
+// Returns FALSE if the caller should launch the object itself.
+static IPTR WBApp__WBAM_Launch(Class *cl, Object *obj, struct wbam_Launch *wbaml)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbApp *my = INST_DATA(cl, obj);
+
+    return wbLauncherOpen(my->Launcher, wbaml->wbaml_Lock, wbaml->wbaml_File);
+}
+
+// Returns FALSE if the caller should do the operation itself.
+static IPTR WBApp__WBAM_QueueJob(Class *cl, Object *obj, struct wbam_QueueJob *wbamq)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbApp *my = INST_DATA(cl, obj);
+
+    if (my->Worker == NULL) {
+        return FALSE;
+    }
+
+    struct wbJob *job = wbJobNew(wbamq->wbamq_Type, wbamq->wbamq_Lock, wbamq->wbamq_File, wbamq->wbamq_Args, wbamq->wbamq_TargetX, wbamq->wbamq_TargetY);
+    if (job == NULL) {
+        return FALSE;
+    }
+
+    job->wj_Progress.wp_Flags = my->CopyFlags;
+
+    AddTailMinList(&my->Jobs, &job->wj_Node);
+    wbWorkerQueue(my->Worker, job);
+
+    wbAppJobsStatus(cl, obj);
+
+    return TRUE;
+}
+
 static IPTR WBApp_dispatcher(Class *cl, Object *obj, Msg msg)
 {
     IPTR rc = 0;
@@ -858,6 +1491,11 @@ static IPTR WBApp_dispatcher(Class *cl, Object *obj, Msg msg)
     METHOD_CASE(WBApp, WBAM_ClearSelected);
     METHOD_CASE(WBApp, WBAM_ReportSelected);
     METHOD_CASE(WBApp, WBAM_InvalidateContents);
+    METHOD_CASE(WBApp, WBAM_OpenDrawer);
+    METHOD_CASE(WBApp, WBAM_OpenSelected);
+    METHOD_CASE(WBApp, WBAM_Launch);
+    METHOD_CASE(WBApp, WBAM_QueueJob);
+    METHOD_CASE(WBApp, WBAM_BackdropResolved);
     default:           rc = DoSuperMethodA(cl, obj, msg); break;
     }
 
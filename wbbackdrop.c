@@ -33,13 +33,18 @@
 struct wbBackdropVolume {
     struct Node bv_Node;
     BPTR bv_Lock;
-    struct List bv_Backdrops;
+    BPTR bv_Volume;     // fl_Volume of bv_Lock.
+    struct wbBackdropList bv_Backdrops;
+    BOOL bv_Dirty;      // bv_Backdrops has changed since .backdrop was written.
 };
 
 struct wbBackdrop {
     struct List Volumes;
 };
 
+// Entries locked per WBBM_Prune.
+#define WBBACKDROP_PRUNE    4
+
 static IPTR WBBackdrop__OM_NEW(Class *cl, Object *obj, struct opSet *ops)
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
@@ -57,6 +62,86 @@ static IPTR WBBackdrop__OM_NEW(Class *cl, Object *obj, struct opSet *ops)
     return rc;
 }
 
+// Volume of a lock, from the lock itself.
+static inline BPTR wbBackdropVolumeKey(BPTR lock)
+{
+    struct FileLock *fl = BADDR(lock);
+    return fl->fl_Volume;
+}
+
+// Find the managed volume that a lock is on, without asking its filesystem.
+static struct wbBackdropVolume *wbBackdropVolumeOf(Class *cl, Object *obj, BPTR lock)
+{
+    struct wbBackdrop *my = INST_DATA(cl, obj);
+    BPTR volume = wbBackdropVolumeKey(lock);
+
+    struct wbBackdropVolume *node;
+    ForeachNode(&my->Volumes, node) {
+        if (node->bv_Volume == volume) {
+            return node;
+        }
+    }
+
+    return NULL;
+}
+
+// Lock up to 'count' of a volume's pending entries. Stale entries are
+// dropped, and the volume is marked to be written out. The WBApp is told
+// of each entry that is locked, so that its icon can be shown.
+static void wbBackdropResolve(Class *cl, Object *obj, struct wbBackdropVolume *node, ULONG count)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+
+    // Entries that can't be locked yet go to the back of the pending
+    // list, so look at each pending entry at most once.
+    ULONG pending = 0;
+    struct MinNode *mn;
+    ForeachNode(&node->bv_Backdrops.wbb_Pending, mn) {
+        pending++;
+    }
+    if (count > pending) {
+        count = pending;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    BPTR pwd = CurrentDir(node->bv_Lock);
+    for (; count > 0; count--) {
+        struct wbBackdropEntry *wbe = wbBackdropPending(&node->bv_Backdrops);
+        if (wbBackdropResolveCurrent(&node->bv_Backdrops, wbe) != NULL) {
+            if (wb->wb_App != NULL) {
+                DoMethod(wb->wb_App, WBAM_BackdropResolved, wbe->wbe_Lock);
+            }
+        } else if (wbBackdropStale(IoErr())) {
+            // Only entries that are gone are dropped from .backdrop.
+            node->bv_Dirty = TRUE;
+        }
+    }
+    CurrentDir(pwd);
+}
+
+// Write out a volume's .backdrop, if it has changed.
+static void wbBackdropFlush(Class *cl, Object *obj, struct wbBackdropVolume *node)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+
+    if (!node->bv_Dirty) {
+        return;
+    }
+
+    BPTR pwd = CurrentDir(node->bv_Lock);
+    if (wbBackdropSaveCurrent(&node->bv_Backdrops)) {
+        D(bug("%s: Saved volume(%s) .backdrop\n", __func__, sLOCKNAME(node->bv_Lock)));
+    } else {
+        D(bug("%s: Unable to save volume(%s) .backdrop\n", __func__, sLOCKNAME(node->bv_Lock)));
+    }
+    CurrentDir(pwd);
+
+    // Don't retry a write-protected volume on every flush.
+    node->bv_Dirty = FALSE;
+}
+
 static IPTR WBBackdrop__OM_DISPOSE(Class *cl, Object *obj, Msg msg)
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
@@ -65,6 +150,7 @@ static IPTR WBBackdrop__OM_DISPOSE(Class *cl, Object *obj, Msg msg)
     struct wbBackdropVolume *node;
     while ((node = (struct wbBackdropVolume *)RemHead(&my->Volumes)) != NULL) {
         Remove(&node->bv_Node);
+        wbBackdropFlush(cl, obj, node);
         wbBackdropFree(&node->bv_Backdrops);
         UnLock(node->bv_Lock);
         FreeVec(node);
@@ -73,56 +159,63 @@ static IPTR WBBackdrop__OM_DISPOSE(Class *cl, Object *obj, Msg msg)
     return DoSuperMethodA(cl, obj, msg);
 }
 
-static IPTR WBBackdrop__WBBM_LockIs(Class *cl, Object *obj, struct wbbm_Lock *wbbml)
+static IPTR WBBackdrop__WBBM_LockIs(Class *cl, Object *obj, struct wbbm_LockKey *wbbmlk)
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
-    struct wbBackdrop *my = INST_DATA(cl, obj);
 
-    BPTR wlock = wbbml->wbbml_Lock;
+    BPTR wlock = wbbmlk->wbbmlk_Lock;
     if (wlock == BNULL) {
         return FALSE;
     }
 
-    BOOL ok = FALSE;
-    struct wbBackdropVolume *node;
-    ForeachNode(&my->Volumes, node) {
-        ok = wbBackdropContains(&node->bv_Backdrops, wlock);
-        if (ok) {
-            break;
-        }
+    // Called for every icon in a drawer - only path key matches cost a packet.
+    // Pending entries aren't locked here; WBBM_Prune does that, a few at a
+    // time, and WBAM_BackdropResolved then moves each one out of its drawer.
+    struct wbBackdropVolume *node = wbBackdropVolumeOf(cl, obj, wlock);
+    if (node == NULL) {
+        return FALSE;
     }
 
-    return ok;
+    return wbBackdropContains(&node->bv_Backdrops, wbbmlk->wbbmlk_Key, wlock);
 }
 
-static IPTR WBBackdrop__WBBM_LockNext(Class *cl, Object *obj, struct wbbm_Lock *wbbml)
+static IPTR WBBackdrop__WBBM_LockNext(Class *cl, Object *obj, struct wbbm_LockNext *wbbmln)
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
     struct wbBackdrop *my = INST_DATA(cl, obj);
+    struct wbbm_Cursor *cursor = wbbmln->wbbmln_Cursor;
 
-    BPTR wlock = wbbml->wbbml_Lock;
+    struct wbBackdropVolume *node = cursor->wbbmc_Volume;
+    struct wbBackdropEntry *wbe = cursor->wbbmc_Entry;
 
-    struct wbBackdropVolume *node;
-    BPTR next = BNULL;
-    ForeachNode(&my->Volumes, node) {
-        BOOL present = wbBackdropNext(&node->bv_Backdrops, wlock, &next);
-        if (next != BNULL) {
-            break;
-        }
-        if (wlock != BNULL && present) {
-            // It was at the end of this list. Get the first of the following list.
-            wlock = BNULL;
+    if (node == NULL) {
+        node = (struct wbBackdropVolume *)GetHead(&my->Volumes);
+        wbe = NULL;
+    }
+
+    for (; node != NULL && node->bv_Node.ln_Succ != NULL; node = (struct wbBackdropVolume *)node->bv_Node.ln_Succ, wbe = NULL) {
+        // Pending entries are left to WBBM_Prune.
+        do {
+            wbe = wbBackdropNext(&node->bv_Backdrops, wbe);
+        } while (wbe != NULL && wbe->wbe_Lock == BNULL);
+        if (wbe != NULL) {
+            cursor->wbbmc_Volume = node;
+            cursor->wbbmc_Entry = wbe;
+            cursor->wbbmc_Key = wbe->wbe_Key;
+            return (IPTR)wbe->wbe_Lock;
         }
     }
 
-    return next;
+    cursor->wbbmc_Volume = NULL;
+    cursor->wbbmc_Entry = NULL;
+
+    return (IPTR)BNULL;
 }
 
 
 static IPTR WBBackdrop__WBBM_LockAdd(Class *cl, Object *obj, struct wbbm_Lock *wbbml)
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
-    struct wbBackdrop *my = INST_DATA(cl, obj);
 
     BPTR wlock = wbbml->wbbml_Lock;
     if (wlock == BNULL) {
@@ -130,53 +223,46 @@ static IPTR WBBackdrop__WBBM_LockAdd(Class *cl, Object *obj, struct wbbm_Lock *w
     }
 
     BOOL ok = FALSE;
-    struct wbBackdropVolume *node;
     D(bug("%s: Add lock(%s) to it's volume backdrop.\n", __func__, sLOCKNAME(wlock)));
-    ForeachNode(&my->Volumes, node) {
-        D(bug("%s: Inspect volume: %s\n", __func__, sLOCKNAME(node->bv_Lock)));
-        if (SameDevice(node->bv_Lock, wlock)) {
-            // Same volume
-            D(bug("%s: New lock on the same volume\n", __func__));
-            ok = wbBackdropAdd(&node->bv_Backdrops, wlock);
-            D(if (!ok) bug("%s: Unable to add lock to volume(%s) .backdrop\n", __func__, sLOCKNAME(node->bv_Lock)));
-            if (ok) {
-                BPTR pwd = CurrentDir(node->bv_Lock);
-                ok = wbBackdropSaveCurrent(&node->bv_Backdrops);
-                D(if (ok) bug("%s: Saved volume(%s) .backdrop\n", __func__, sLOCKNAME(node->bv_Lock)));
-                D(if (!ok) bug("%s: Unable to save volume(%s) .backdrop\n", __func__, sLOCKNAME(node->bv_Lock)));
-                CurrentDir(pwd);
-            }
-            break;
+    struct wbBackdropVolume *node = wbBackdropVolumeOf(cl, obj, wlock);
+    if (node != NULL) {
+        D(bug("%s: New lock on volume %s\n", __func__, sLOCKNAME(node->bv_Lock)));
+        // A pending entry for this lock's path is found by its path.
+        ok = wbBackdropAdd(&node->bv_Backdrops, wlock);
+        D(if (!ok) bug("%s: Unable to add lock to volume(%s) .backdrop\n", __func__, sLOCKNAME(node->bv_Lock)));
+        if (ok) {
+            // Written out by WBBM_Flush.
+            node->bv_Dirty = TRUE;
         }
     }
 
     return ok;
 }
 
-static IPTR WBBackdrop__WBBM_LockDel(Class *cl, Object *obj, struct wbbm_Lock *wbbml)
+static IPTR WBBackdrop__WBBM_LockDel(Class *cl, Object *obj, struct wbbm_LockKey *wbbmlk)
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
-    struct wbBackdrop *my = INST_DATA(cl, obj);
 
-    BPTR wlock = wbbml->wbbml_Lock;
+    BPTR wlock = wbbmlk->wbbmlk_Lock;
     if (wlock == BNULL) {
         return FALSE;
     }
 
     BOOL ok = FALSE;
-    struct wbBackdropVolume *node;
+    ULONG key = wbbmlk->wbbmlk_Key;
     D(bug("%s: Del lock(%s) from it's volume backdrop.\n", __func__, sLOCKNAME(wlock)));
-    ForeachNode(&my->Volumes, node) {
-        D(bug("%s: Inspect volume: %s\n", __func__, sLOCKNAME(node->bv_Lock)));
-        if (SameDevice(node->bv_Lock, wlock)) {
-            // Same volume.
-            ok = wbBackdropDel(&node->bv_Backdrops, wlock);
-            if (ok) {
-                BPTR pwd = CurrentDir(node->bv_Lock);
-                wbBackdropSaveCurrent(&node->bv_Backdrops);
-                CurrentDir(pwd);
-            }
-            break;
+    struct wbBackdropVolume *node = wbBackdropVolumeOf(cl, obj, wlock);
+    if (node != NULL) {
+        // Only pending entries with the same path key need locking.
+        BPTR pwd = CurrentDir(node->bv_Lock);
+        if (wbBackdropResolveKeyCurrent(&node->bv_Backdrops, key)) {
+            node->bv_Dirty = TRUE;
+        }
+        CurrentDir(pwd);
+        ok = wbBackdropDel(&node->bv_Backdrops, key, wlock);
+        if (ok) {
+            // Written out by WBBM_Flush.
+            node->bv_Dirty = TRUE;
         }
     }
 
@@ -211,6 +297,7 @@ static IPTR WBBackdrop__WBBM_VolumeAdd(Class *cl, Object *obj, struct wbbm_Lock
             CurrentDir(pwd);
 
             node->bv_Lock = lock;
+            node->bv_Volume = wbBackdropVolumeKey(lock);
             AddTail(&my->Volumes, &node->bv_Node);
 
             ok = TRUE;
@@ -237,6 +324,7 @@ static IPTR WBBackdrop__WBBM_VolumeDel(Class *cl, Object *obj, struct wbbm_Lock
         if (SameLock(node->bv_Lock, wlock) == LOCK_SAME) {
             // Same volume lock.
             Remove(&node->bv_Node);
+            wbBackdropFlush(cl, obj, node);
             wbBackdropFree(&node->bv_Backdrops);
             UnLock(node->bv_Lock);
             FreeVec(node);
@@ -247,6 +335,42 @@ static IPTR WBBackdrop__WBBM_VolumeDel(Class *cl, Object *obj, struct wbbm_Lock
     return TRUE;
 }
 
+// Changes are collected, so that (for example) leaving out many icons
+// writes each .backdrop once, rather than once per icon.
+static IPTR WBBackdrop__WBBM_Flush(Class *cl, Object *obj, Msg msg)
+{
+    struct wbBackdrop *my = INST_DATA(cl, obj);
+
+    struct wbBackdropVolume *node;
+    ForeachNode(&my->Volumes, node) {
+        wbBackdropFlush(cl, obj, node);
+    }
+
+    return TRUE;
+}
+
+// Entries are locked, and stale ones found, a few at a time while Workbook
+// is otherwise idle, so that a large or stale .backdrop doesn't hold up the
+// root window. Each entry's icon is added as it is locked.
+static IPTR WBBackdrop__WBBM_Prune(Class *cl, Object *obj, Msg msg)
+{
+    struct wbBackdrop *my = INST_DATA(cl, obj);
+
+    BOOL pending = FALSE;
+    ULONG count = WBBACKDROP_PRUNE;
+    struct wbBackdropVolume *node;
+    ForeachNode(&my->Volumes, node) {
+        if (count > 0 && wbBackdropPending(&node->bv_Backdrops) != NULL) {
+            wbBackdropResolve(cl, obj, node, count);
+            count = 0;
+        }
+        if (wbBackdropPending(&node->bv_Backdrops) != NULL) {
+            pending = TRUE;
+        }
+    }
+
+    return pending;
+}
 
 static IPTR WBBackdrop_dispatcher(Class *cl, Object *obj, Msg msg)
 {
@@ -262,6 +386,8 @@ static IPTR WBBackdrop_dispatcher(Class *cl, Object *obj, Msg msg)
     METHOD_CASE(WBBackdrop, WBBM_LockDel);
     METHOD_CASE(WBBackdrop, WBBM_VolumeAdd);
     METHOD_CASE(WBBackdrop, WBBM_VolumeDel);
+    METHOD_CASE(WBBackdrop, WBBM_Flush);
+    METHOD_CASE(WBBackdrop, WBBM_Prune);
     default:               rc = DoSuperMethodA(cl, obj, msg); break;
     }
 
@@ -25,6 +25,10 @@
 #include <proto/icon.h>
 #include <proto/utility.h>
 
+#include <dos/dosextens.h>
+#include <dos/exall.h>
+#include <workbench/icon.h>
+
 #ifdef __AROS__
 #include <exec/rawfmt.h>
 #endif
@@ -72,48 +76,303 @@ STRPTR _wbAbspathCurrent(struct Library *DOSBase, CONST_STRPTR file)
     return path;
 }
 
-// Forward reference.
-static BOOL wbDeleteThisCurrent(struct Library *DOSBase, CONST_STRPTR file, struct FileInfoBlock *fib);
+// Has the owner of the operation asked us to stop?
+static BOOL wbProgressCancelled(struct Library *DOSBase, struct wbProgress *progress)
+{
+    if (progress != NULL && progress->wp_Cancel) {
+        SetIoErr(ERROR_BREAK);
+        return TRUE;
+    }
+
+    return FALSE;
+}
 
-// Delete the contents of a directory.
-// NOTE: 'fib' must _already_ have been Examine(dir, fib)'d !!!
-static BOOL wbDeleteInto(struct Library *DOSBase, BPTR dir, struct FileInfoBlock *fib)
+// Size of each ExAll() buffer used by the tree walk.
+#define WBWALK_EXALL_SIZE 4096
+
+// ExAll() data requested by the tree walk.
+#define WBWALK_EXALL_DATA ED_DATE
+
+// A batch of entries from ExAll().
+struct wbWalkBatch {
+    struct MinNode    wwb_Node;
+    struct ExAllData *wwb_Next;     // Next entry to visit.
+    LONG              wwb_Buffer[WBWALK_EXALL_SIZE / sizeof(LONG)];
+};
+
+// A directory on the walk stack.
+struct wbWalkDir {
+    struct MinNode    wwd_Node;
+    BPTR              wwd_Lock;
+    struct ExAllData *wwd_Entry;    // Entry in the parent's batch. NULL for the top.
+    struct MinList    wwd_Batches;
+};
+
+// Should the walk descend into this entry?
+static inline BOOL wbWalkIsDir(struct ExAllData *ead)
+{
+    return ead->ed_Type > 0 && ead->ed_Type != ST_SOFTLINK && ead->ed_Type != ST_LINKDIR;
+}
+
+static void wbWalkDirFree(struct Library *DOSBase, struct wbWalkDir *wwd)
+{
+    struct wbWalkBatch *wwb;
+
+    while ((wwb = (struct wbWalkBatch *)RemHead((struct List *)&wwd->wwd_Batches)) != NULL) {
+        FreeVec(wwb);
+    }
+
+    // We only own the locks of the subdirectories.
+    if (wwd->wwd_Entry != NULL && wwd->wwd_Lock != BNULL) {
+        UnLock(wwd->wwd_Lock);
+    }
+
+    FreeVec(wwd);
+}
+
+// Read all of the entries in a directory, before the callbacks start disturbing it.
+// NOTE: This routine _eats_ lock, if entry != NULL, even on failure.
+static struct wbWalkDir *wbWalkDirNew(struct Library *DOSBase, BPTR lock, struct ExAllData *entry)
+{
+    struct wbWalkDir *wwd = AllocVec(sizeof(*wwd), MEMF_ANY);
+    if (wwd == NULL) {
+        if (entry != NULL) {
+            UnLock(lock);
+        }
+        SetIoErr(ERROR_NO_FREE_STORE);
+        return NULL;
+    }
+
+    wwd->wwd_Lock = lock;
+    wwd->wwd_Entry = entry;
+    NEWLIST(&wwd->wwd_Batches);
+
+    struct ExAllControl *eac = AllocDosObject(DOS_EXALLCONTROL, NULL);
+    if (eac == NULL) {
+        wbWalkDirFree(DOSBase, wwd);
+        SetIoErr(ERROR_NO_FREE_STORE);
+        return NULL;
+    }
+
+    BOOL more = FALSE;
+    LONG err = 0;
+    eac->eac_LastKey = 0;
+    do {
+        struct wbWalkBatch *wwb = AllocVec(sizeof(*wwb), MEMF_ANY);
+        if (wwb == NULL) {
+            if (more) {
+                LONG scratch[64];
+                ExAllEnd(lock, (struct ExAllData *)scratch, sizeof(scratch), WBWALK_EXALL_DATA, eac);
+            }
+            err = ERROR_NO_FREE_STORE;
+            break;
+        }
+
+        more = ExAll(lock, (struct ExAllData *)wwb->wwb_Buffer, sizeof(wwb->wwb_Buffer), WBWALK_EXALL_DATA, eac);
+        err = IoErr();
+        if (!more && err != ERROR_NO_MORE_ENTRIES) {
+            FreeVec(wwb);
+            break;
+        }
+        err = 0;
+
+        if (eac->eac_Entries == 0) {
+            FreeVec(wwb);
+        } else {
+            wwb->wwb_Next = (struct ExAllData *)wwb->wwb_Buffer;
+            AddTail((struct List *)&wwd->wwd_Batches, (struct Node *)&wwb->wwb_Node);
+        }
+    } while (more);
+
+    FreeDosObject(DOS_EXALLCONTROL, eac);
+
+    if (err != 0) {
+        wbWalkDirFree(DOSBase, wwd);
+        SetIoErr(err);
+        return NULL;
+    }
+
+    return wwd;
+}
+
+// Next entry to visit in a directory, or NULL if there are none left.
+// NOTE: An entry stays valid until the following call.
+static struct ExAllData *wbWalkDirNext(struct wbWalkDir *wwd)
+{
+    struct wbWalkBatch *wwb;
+
+    while ((wwb = (struct wbWalkBatch *)GetHead((struct List *)&wwd->wwd_Batches)) != NULL) {
+        struct ExAllData *ead = wwb->wwb_Next;
+        if (ead != NULL) {
+            wwb->wwb_Next = ead->ed_Next;
+            return ead;
+        }
+        RemHead((struct List *)&wwd->wwd_Batches);
+        FreeVec(wwb);
+    }
+
+    return NULL;
+}
+
+// Walk a directory tree.
+//
+// Each directory is read once, in ExAll() batches, and its entries are then
+// visited from that list. Subdirectories are pushed onto an explicit stack,
+// so deep trees don't use up the process stack.
+BOOL _wbWalkLock(struct Library *DOSBase, BPTR dir, wbWalkFunc pre, wbWalkFunc post, APTR arg, struct wbProgress *progress)
 {
     ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
 
-    BPTR olddir = CurrentDir(dir);
+    struct MinList stack;
+    struct wbWalkDir *wwd;
     BOOL ok = TRUE;
     LONG err = 0;
 
-    while (ExNext(dir, fib)) {
-        STRPTR file = StrDup(fib->fib_FileName);
-        if (file) {
-            ok = wbDeleteThisCurrent(DOSBase, file, fib);
-            FreeVec(file);
-        } else {
+    BPTR olddir = CurrentDir(BNULL);
+    CurrentDir(olddir);
+
+    NEWLIST(&stack);
+
+    wwd = wbWalkDirNew(DOSBase, dir, NULL);
+    if (wwd == NULL) {
+        return FALSE;
+    }
+    AddHead((struct List *)&stack, (struct Node *)&wwd->wwd_Node);
+
+    while (ok && (wwd = (struct wbWalkDir *)GetHead((struct List *)&stack)) != NULL) {
+        if (wbProgressCancelled(DOSBase, progress)) {
+            err = ERROR_BREAK;
             ok = FALSE;
+            break;
         }
 
-        if (!ok) {
-            break;
+        struct ExAllData *ead = wbWalkDirNext(wwd);
+        if (ead == NULL) {
+            // This directory is done.
+            RemHead((struct List *)&stack);
+            if (wwd->wwd_Entry != NULL) {
+                struct wbWalkDir *parent = (struct wbWalkDir *)GetHead((struct List *)&stack);
+                UnLock(wwd->wwd_Lock);
+                wwd->wwd_Lock = BNULL;
+                if (post != NULL) {
+                    CurrentDir(parent->wwd_Lock);
+                    if (post(DOSBase, wwd->wwd_Entry, arg) == WBWALK_STOP) {
+                        err = IoErr();
+                        ok = FALSE;
+                    }
+                }
+            }
+            wbWalkDirFree(DOSBase, wwd);
+            continue;
         }
 
-        // Re-Examine the directory, as we may have disturbed the directory's ExNext() chains.
-        ok = Examine(dir, fib);
-        if (!ok) {
-            break;
+        CurrentDir(wwd->wwd_Lock);
+
+        LONG action = WBWALK_CONTINUE;
+        if (pre != NULL) {
+            action = pre(DOSBase, ead, arg);
+            if (action == WBWALK_STOP) {
+                err = IoErr();
+                ok = FALSE;
+                break;
+            }
+        }
+
+        if (action == WBWALK_CONTINUE && wbWalkIsDir(ead)) {
+            BPTR lock = Lock(ead->ed_Name, SHARED_LOCK);
+            if (lock == BNULL) {
+                err = IoErr();
+                ok = FALSE;
+                break;
+            }
+            struct wbWalkDir *child = wbWalkDirNew(DOSBase, lock, ead);
+            if (child == NULL) {
+                err = IoErr();
+                ok = FALSE;
+                break;
+            }
+            AddHead((struct List *)&stack, (struct Node *)&child->wwd_Node);
         }
     }
 
-    err = IoErr();
+    // Clean up anything left over from a failure.
+    while ((wwd = (struct wbWalkDir *)RemHead((struct List *)&stack)) != NULL) {
+        wbWalkDirFree(DOSBase, wwd);
+    }
+
     CurrentDir(olddir);
 
-    SetIoErr(err);
+    SetIoErr(ok ? 0 : err);
     return ok;
 }
 
+// Size walk: count everything.
+static LONG wbSizeWalk(struct Library *DOSBase, struct ExAllData *ead, APTR arg)
+{
+    struct wbSize *size = arg;
+
+    size->ws_Files++;
+    size->ws_Blocks++;
+    if (!wbWalkIsDir(ead)) {
+        size->ws_Bytes += ead->ed_Size;
+        if (size->ws_BlockSize != 0) {
+            size->ws_Blocks += (ead->ed_Size + size->ws_BlockSize - 1) / size->ws_BlockSize;
+        }
+    }
+
+    return WBWALK_CONTINUE;
+}
+
+// Add up the size of the contents of a directory.
+BOOL _wbSizeLock(struct Library *DOSBase, BPTR dir, struct wbSize *size, struct wbProgress *progress)
+{
+    return wbWalkLock(dir, wbSizeWalk, NULL, size, progress);
+}
+
+// Delete walk: files on the way down, directories once they are empty.
+static LONG wbDeleteWalkPre(struct Library *DOSBase, struct ExAllData *ead, APTR arg)
+{
+    struct wbProgress *progress = arg;
+
+    if (wbWalkIsDir(ead)) {
+        return WBWALK_CONTINUE;
+    }
+
+    // Links are deleted, not followed.
+    if (!DeleteFile(ead->ed_Name)) {
+        return WBWALK_STOP;
+    }
+
+    if (progress != NULL) {
+        progress->wp_Files++;
+    }
+
+    return WBWALK_CONTINUE;
+}
+
+static LONG wbDeleteWalkPost(struct Library *DOSBase, struct ExAllData *ead, APTR arg)
+{
+    struct wbProgress *progress = arg;
+
+    if (!DeleteFile(ead->ed_Name)) {
+        return WBWALK_STOP;
+    }
+
+    if (progress != NULL) {
+        progress->wp_Files++;
+    }
+
+    return WBWALK_CONTINUE;
+}
+
+// Delete the contents of a directory.
+static BOOL wbDeleteInto(struct Library *DOSBase, BPTR dir, struct wbProgress *progress)
+{
+    return wbWalkLock(dir, wbDeleteWalkPre, wbDeleteWalkPost, progress, progress);
+}
+
 // Delete a single file or directory.
-static BOOL wbDeleteThisCurrent(struct Library *DOSBase, CONST_STRPTR file, struct FileInfoBlock *fib)
+static BOOL wbDeleteThisCurrent(struct Library *DOSBase, CONST_STRPTR file, struct FileInfoBlock *fib, struct wbProgress *progress)
 {
     ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
 
@@ -128,9 +387,9 @@ static BOOL wbDeleteThisCurrent(struct Library *DOSBase, CONST_STRPTR file, stru
     } else {
         ok = Examine(lock, fib);
         if (ok) {
-            if (fib->fib_DirEntryType >= 0) {
+            if (fib->fib_DirEntryType >= 0 && fib->fib_DirEntryType != ST_SOFTLINK && fib->fib_DirEntryType != ST_LINKDIR) {
                 // A directory - clear it out!
-                ok = wbDeleteInto(DOSBase, lock, fib);
+                ok = wbDeleteInto(DOSBase, lock, progress);
             }
         }
         err = IoErr();
@@ -139,6 +398,9 @@ static BOOL wbDeleteThisCurrent(struct Library *DOSBase, CONST_STRPTR file, stru
             // Just a file (or a now empty directory);
             ok = DeleteFile(file);
             err = IoErr();
+            if (ok && progress != NULL) {
+                progress->wp_Files++;
+            }
         }
     }
 
@@ -147,7 +409,7 @@ static BOOL wbDeleteThisCurrent(struct Library *DOSBase, CONST_STRPTR file, stru
 }
 
 // Delete a file, a directory, or just the contents of a directory.
-BOOL _wbDeleteFromCurrent(struct Library *DOSBase, struct Library *IconBase, CONST_STRPTR file, BOOL only_contents)
+BOOL _wbDeleteFromCurrent(struct Library *DOSBase, struct Library *IconBase, CONST_STRPTR file, BOOL only_contents, struct wbProgress *progress)
 {
     ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
 
@@ -169,13 +431,13 @@ BOOL _wbDeleteFromCurrent(struct Library *DOSBase, struct Library *IconBase, CON
                 ok = FALSE;
             }
             if (ok) {
-                ok = wbDeleteInto(DOSBase, lock, fib);
+                ok = wbDeleteInto(DOSBase, lock, progress);
             }
             err = IoErr();
             UnLock(lock);
         }
     } else {
-        ok = wbDeleteThisCurrent(DOSBase, file, fib);
+        ok = wbDeleteThisCurrent(DOSBase, file, fib, progress);
         err = IoErr();
 
         // Lastly, delete the icon.
@@ -192,28 +454,20 @@ BOOL _wbDeleteFromCurrent(struct Library *DOSBase, struct Library *IconBase, CON
 
 #define WBBUMP_LENGTH_MAX   19  // Copy_2147483648_of_... (copy 2^31)
 
-// Get the next 'Copy_of_...' name for a file.
-// Examples:
-//
-// 'FooBar' => 'Copy_of_FooBar'
-// 'Copy_of_FooBar' => 'Copy_2_of_FooBar'
-// 'Qux' [and 'Copy_of_Qux' and 'Copy_2_of_Qux' present] => 'Copy_3_of_Qux'
-// 'Copy_999_of_Xyyzy' => 'Copy_1000_of_Xyyzy'
-// 'Copy of Some' => 'Copy_of_Copy of Some'
-//
-// Enhanced version of 'icon.library/BumpRevision' that can handle input names up to FILENAME_MAX - 19 in length.
-static BOOL wbBumpRevisionCurrent(struct Library *DOSBase, CONST_STRPTR oldname, STRPTR newname)
+// Split a 'Copy_N_of_...' name into its index and the name it is a copy of.
+// Returns 0, and the whole name, if it is not a copy.
+static ULONG wbBumpParse(CONST_STRPTR name, CONST_STRPTR *base)
 {
-    ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
-
-    // Determine the current index.
     ULONG index = 0;
     enum { PREFIX, NUMBER, SUFFIX, DONE } state;
     state = PREFIX;
     int substate = 0;
     CONST_STRPTR prefix = "copy";
     CONST_STRPTR suffix = "of";
-    for (CONST_STRPTR cp = oldname; state != DONE && *cp != 0; cp++, substate++) {
+
+    *base = name;
+
+    for (CONST_STRPTR cp = name; state != DONE && *cp != 0; cp++, substate++) {
         switch (state) {
         case PREFIX:
             if (prefix[substate] == 0 && *cp == '_') {
@@ -241,7 +495,7 @@ static BOOL wbBumpRevisionCurrent(struct Library *DOSBase, CONST_STRPTR oldname,
             break;
         case SUFFIX:
             if (suffix[substate] == 0 && *cp == '_' && cp[1] != 0) {
-                oldname = &cp[1];
+                *base = &cp[1];
                 state = DONE;
             } else if ((suffix[substate]|0x20) != ((*cp) | 0x20)) {
                 index = 0;
@@ -253,11 +507,184 @@ static BOOL wbBumpRevisionCurrent(struct Library *DOSBase, CONST_STRPTR oldname,
         }
     }
 
+    // Only a complete 'Copy_..._of_' prefix counts.
+    if (*base == name) {
+        index = 0;
+    }
+
+    return index;
+}
+
+// A name with copies in the cached directory.
+struct wbBumpName {
+    struct MinNode wbn_Node;
+    ULONG          wbn_Index;   // Highest 'Copy_N_of_' index in use.
+    STRPTR         wbn_Name;
+};
+
+static inline TEXT wbNameFold(TEXT c)
+{
+    return (c >= 'A' && c <= 'Z') ? (c - 'A' + 'a') : c;
+}
+
+// AmigaDOS names are case insensitive.
+static BOOL wbNameSame(CONST_STRPTR a, CONST_STRPTR b)
+{
+    for (; *a != 0 && wbNameFold(*a) == wbNameFold(*b); a++, b++);
+
+    return *a == 0 && *b == 0;
+}
+
+static struct wbBumpName *wbBumpCacheFind(struct wbBumpCache *cache, CONST_STRPTR base)
+{
+    struct wbBumpName *wbn;
+
+    ForeachNode(&cache->wbc_Names, wbn) {
+        if (wbNameSame(wbn->wbn_Name, base)) {
+            return wbn;
+        }
+    }
+
+    return NULL;
+}
+
+// Record that 'Copy_<index>_of_<base>' is in use.
+static void wbBumpCacheNote(struct wbBumpCache *cache, CONST_STRPTR base, ULONG index)
+{
+    struct wbBumpName *wbn = wbBumpCacheFind(cache, base);
+    if (wbn == NULL) {
+        LONG len = STRLEN(base) + 1;
+        wbn = AllocVec(sizeof(*wbn) + len, MEMF_ANY);
+        if (wbn == NULL) {
+            // Not fatal - wbBumpRevisionCurrent() checks the name it picks.
+            return;
+        }
+        wbn->wbn_Index = 0;
+        wbn->wbn_Name = (STRPTR)&wbn[1];
+        CopyMem(base, wbn->wbn_Name, len);
+        AddTail((struct List *)&cache->wbc_Names, (struct Node *)&wbn->wbn_Node);
+    }
+
+    if (index > wbn->wbn_Index) {
+        wbn->wbn_Index = index;
+    }
+}
+
+// Find all of the 'Copy_N_of_...' names in a directory, in one pass.
+static void wbBumpCacheScan(struct Library *DOSBase, struct wbBumpCache *cache, BPTR dir)
+{
+    TEXT pattern[32];
+    if (ParsePatternNoCase("copy_#?", pattern, sizeof(pattern)) < 0) {
+        return;
+    }
+
+    struct ExAllControl *eac = AllocDosObject(DOS_EXALLCONTROL, NULL);
+    if (eac == NULL) {
+        return;
+    }
+
+    LONG *buffer = AllocVec(WBWALK_EXALL_SIZE, MEMF_ANY);
+    if (buffer != NULL) {
+        BOOL more;
+        eac->eac_LastKey = 0;
+        eac->eac_MatchString = pattern;
+        do {
+            more = ExAll(dir, (struct ExAllData *)buffer, WBWALK_EXALL_SIZE, ED_NAME, eac);
+            if (!more && IoErr() != ERROR_NO_MORE_ENTRIES) {
+                break;
+            }
+            if (eac->eac_Entries == 0) {
+                continue;
+            }
+            for (struct ExAllData *ead = (struct ExAllData *)buffer; ead != NULL; ead = ead->ed_Next) {
+                CONST_STRPTR base;
+                ULONG index = wbBumpParse(ead->ed_Name, &base);
+                if (index != 0) {
+                    wbBumpCacheNote(cache, base, index);
+                }
+            }
+        } while (more);
+        FreeVec(buffer);
+    }
+
+    FreeDosObject(DOS_EXALLCONTROL, eac);
+}
+
+void wbBumpCacheInit(struct wbBumpCache *cache)
+{
+    InitSemaphore(&cache->wbc_Lock);
+    cache->wbc_Dir = BNULL;
+    NEWLIST(&cache->wbc_Names);
+}
+
+void _wbBumpCacheFree(struct Library *DOSBase, struct wbBumpCache *cache)
+{
+    struct wbBumpName *wbn;
+
+    ObtainSemaphore(&cache->wbc_Lock);
+
+    while ((wbn = (struct wbBumpName *)RemHead((struct List *)&cache->wbc_Names)) != NULL) {
+        FreeVec(wbn);
+    }
+
+    if (cache->wbc_Dir != BNULL) {
+        UnLock(cache->wbc_Dir);
+        cache->wbc_Dir = BNULL;
+    }
+
+    ReleaseSemaphore(&cache->wbc_Lock);
+}
+
+// Get the next 'Copy_of_...' name for a file.
+// Examples:
+//
+// 'FooBar' => 'Copy_of_FooBar'
+// 'Copy_of_FooBar' => 'Copy_2_of_FooBar'
+// 'Qux' [and 'Copy_of_Qux' and 'Copy_2_of_Qux' present] => 'Copy_3_of_Qux'
+// 'Copy_999_of_Xyyzy' => 'Copy_1000_of_Xyyzy'
+// 'Copy of Some' => 'Copy_of_Copy of Some'
+//
+// The directory is scanned once for existing copies, and the result kept in
+// 'cache' for as long as CurrentDir() stays the same. The new name is one past
+// the highest copy found.
+//
+// Enhanced version of 'icon.library/BumpRevision' that can handle input names up to FILENAME_MAX - 19 in length.
+static BOOL wbBumpRevisionCurrent(struct Library *DOSBase, struct wbBumpCache *cache, CONST_STRPTR oldname, STRPTR newname)
+{
+    ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
+
+    // Determine the current index.
+    CONST_STRPTR base;
+    ULONG index = wbBumpParse(oldname, &base);
+
+    BPTR pwd = CurrentDir(BNULL);
+    CurrentDir(pwd);
+
+    // The picked name is noted before the lock is released, so another
+    // process sharing the cache picks the one after it.
+    ObtainSemaphore(&cache->wbc_Lock);
+
+    if (cache->wbc_Dir != BNULL && SameLock(cache->wbc_Dir, pwd) != LOCK_SAME) {
+        wbBumpCacheFree(cache);
+    }
+
+    if (cache->wbc_Dir == BNULL) {
+        cache->wbc_Dir = DupLock(pwd);
+        wbBumpCacheScan(DOSBase, cache, pwd);
+    }
+
+    struct wbBumpName *wbn = wbBumpCacheFind(cache, base);
+    if (wbn != NULL && wbn->wbn_Index > index) {
+        index = wbn->wbn_Index;
+    }
+
+    // Normally the first name is free. If not, someone else made copies
+    // behind our back, so probe onwards from there.
     for (index++; index != 0; index++) {
        if (index == 1) {
-           snprintf(newname, FILENAME_MAX, "Copy_of_%s", oldname);
+           snprintf(newname, FILENAME_MAX, "Copy_of_%s", base);
        } else {
-           snprintf(newname, FILENAME_MAX, "Copy_%d_of_%s", (int)index, oldname);
+           snprintf(newname, FILENAME_MAX, "Copy_%d_of_%s", (int)index, base);
        }
        newname[FILENAME_MAX-1] = 0;
 
@@ -270,6 +697,12 @@ static BOOL wbBumpRevisionCurrent(struct Library *DOSBase, CONST_STRPTR oldname,
        UnLock(lock);
     }
 
+    if (index != 0) {
+        wbBumpCacheNote(cache, base, index);
+    }
+
+    ReleaseSemaphore(&cache->wbc_Lock);
+
     return index != 0;
 }
 
@@ -291,123 +724,1186 @@ CONST_STRPTR _sLOCKNAME(struct Library *DOSBase, BPTR lock) {
 #endif
 
 
-// Copy a single file/directory to here.
-// Does NOT take special care for .icon files!
-// NOTE: This routine _eats_ src_lock!
-static BOOL wbCopyLockCurrent(struct Library *DOSBase, CONST_STRPTR dst_file, BPTR src_lock)
+// CRC-32 (IEEE 802.3) tables, for slice-by-4: table[0] is the classic
+// byte-at-a-time table, and table[n] advances a byte through n more zero bytes.
+static ULONG wbCrc32Table[4][256];
+static volatile BOOL wbCrc32Ready;
+
+static void wbCrc32Init(void)
 {
-    ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
+    for (int i = 0; i < 256; i++) {
+        ULONG crc = i;
+        for (int j = 0; j < 8; j++) {
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+        }
+        wbCrc32Table[0][i] = crc;
+    }
 
-    const size_t buff_size = 4096;
-    BOOL ok = FALSE;
-    LONG err = 0;
+    for (int i = 0; i < 256; i++) {
+        ULONG crc = wbCrc32Table[0][i];
+        for (int n = 1; n < 4; n++) {
+            crc = (crc >> 8) ^ wbCrc32Table[0][crc & 0xff];
+            wbCrc32Table[n][i] = crc;
+        }
+    }
 
-    struct FileInfoBlock *fib = AllocDosObjectTags(DOS_FIB, TAG_END);
-    if (!fib) {
-        D(bug("%s: Can't allocate FIB\n", __func__));
-        UnLock(src_lock);
-        return FALSE;
+    // Several processes may get here at once. They all write the same values.
+    wbCrc32Ready = TRUE;
+}
+
+ULONG wbCrc32(ULONG crc, const void *buff, ULONG len)
+{
+    const UBYTE *cp = buff;
+
+    if (!wbCrc32Ready) {
+        wbCrc32Init();
     }
 
-    // Examine the lock to see what it is.
-    ok = Examine(src_lock, fib);
-    if (ok) {
-        // Cache attributes we may need later.
-        LONG protection = fib->fib_Protection;
+    crc = ~crc;
+
+    // Four bytes per step. The word is assembled a byte at a time, so this
+    // works the same on either byte order.
+    while (len >= 4) {
+        crc ^= (ULONG)cp[0] | ((ULONG)cp[1] << 8) | ((ULONG)cp[2] << 16) | ((ULONG)cp[3] << 24);
+        crc = wbCrc32Table[3][crc & 0xff] ^
+              wbCrc32Table[2][(crc >> 8) & 0xff] ^
+              wbCrc32Table[1][(crc >> 16) & 0xff] ^
+              wbCrc32Table[0][crc >> 24];
+        cp += 4;
+        len -= 4;
+    }
 
-        ok = FALSE;
-        if (fib->fib_DirEntryType>=0) {
-            // Directory copies.
-            BPTR dst_lock = CreateDir(dst_file);
-            err = IoErr();
-            if (dst_lock != BNULL) {
-                // 'cd' into destination dir
-                BPTR pwd = CurrentDir(dst_lock);
-                // Copy all the files in src_lock to dst_lock
-                ok = TRUE;
-                while (ExNext(src_lock, fib)) {
-                    BPTR this_lock;
-                    CurrentDir(src_lock);
-                    this_lock = Lock(fib->fib_FileName, SHARED_LOCK);
-                    CurrentDir(dst_lock);
+    while (len > 0) {
+        crc = (crc >> 8) ^ wbCrc32Table[0][(crc ^ *cp) & 0xff];
+        cp++;
+        len--;
+    }
 
-                    D(if (this_lock == BNULL) bug("%s: Can't lock %s|%s\n", __func__, sCURRDIR(), fib->fib_FileName));
-                    err = IoErr();
-                    if (this_lock != BNULL) {
-                        ok = wbCopyLockCurrent(DOSBase, fib->fib_FileName, this_lock);
-                        err = IoErr();
-                        if (!ok) {
-                            break;
-                        }
-                    }
-                }
-                CurrentDir(pwd);
-                UnLock(dst_lock);
-            } else {
-                D(bug("%s: CreateDir(%s): %ld\n", __func__, dst_file, (IPTR)err));
+    return ~crc;
+}
+
+// Copy buffer limits. The buffer is scaled to the file size and to free memory.
+#define WBCOPY_BUFFER_MIN   (4 * 1024)
+#define WBCOPY_BUFFER_MAX   (256 * 1024)
+
+// Pick a copy buffer size for a file.
+static ULONG wbCopyBufferSize(ULONG file_size)
+{
+    ULONG size = WBCOPY_BUFFER_MAX;
+
+    // No point in a buffer larger than the file.
+    if (size > file_size) {
+        size = file_size;
+    }
+
+    // Leave most of the memory for everyone else. We need two buffers.
+    ULONG largest = AvailMem(MEMF_ANY | MEMF_LARGEST) / 8;
+    if (size > largest) {
+        size = largest;
+    }
+
+    if (size < WBCOPY_BUFFER_MIN) {
+        size = WBCOPY_BUFFER_MIN;
+    }
+
+    // Whole sectors, please.
+    return (size + 511) & ~511;
+}
+
+// An asynchronous read or write packet.
+struct wbCopyPacket {
+    struct StandardPacket *sp;
+    BOOL busy;
+};
+
+// Send a packet to a filehandle's handler.
+static void wbCopyPacketSend(struct Library *DOSBase, struct wbCopyPacket *pkt, struct MsgPort *port, LONG action, BPTR fh, APTR buff, LONG len)
+{
+    struct FileHandle *handle = BADDR(fh);
+    struct DosPacket *dp = &pkt->sp->sp_Pkt;
+
+    dp->dp_Type = action;
+    dp->dp_Arg1 = (SIPTR)handle->fh_Arg1;
+    dp->dp_Arg2 = (SIPTR)buff;
+    dp->dp_Arg3 = len;
+    pkt->busy = TRUE;
+    SendPkt(dp, handle->fh_Type, port);
+}
+
+// Wait for a specific packet to come back, and return its result.
+// Replies for the other packets may arrive first.
+static LONG wbCopyPacketWait(struct Library *DOSBase, struct wbCopyPacket *pkts, int count, struct wbCopyPacket *pkt, struct MsgPort *port, LONG *err)
+{
+    while (pkt->busy) {
+        struct Message *msg;
+
+        WaitPort(port);
+        while ((msg = GetMsg(port)) != NULL) {
+            for (int i = 0; i < count; i++) {
+                if (msg == pkts[i].sp->sp_Pkt.dp_Link) {
+                    pkts[i].busy = FALSE;
+                }
             }
-            UnLock(src_lock);
+        }
+    }
+
+    *err = pkt->sp->sp_Pkt.dp_Res2;
+    return pkt->sp->sp_Pkt.dp_Res1;
+}
+
+// Copy the remaining data of one filehandle to another, a buffer at a time.
+// Used when asynchronous I/O is not possible.
+static BOOL wbCopyDataSync(struct Library *DOSBase, BPTR dstfh, BPTR srcfh, UBYTE *buff, ULONG buff_size, ULONG *crc, struct wbProgress *progress)
+{
+    LONG bytes;
+    LONG err = 0;
+
+    while ((bytes = Read(srcfh, buff, buff_size)) > 0) {
+        LONG copied = Write(dstfh, buff, bytes);
+        if (copied != bytes) {
+            err = (copied < 0) ? IoErr() : ERROR_DISK_FULL;
+            break;
+        }
+        if (crc != NULL) {
+            *crc = wbCrc32(*crc, buff, bytes);
+        }
+        if (progress != NULL) {
+            progress->wp_Bytes += bytes;
+        }
+        if (wbProgressCancelled(DOSBase, progress)) {
+            err = ERROR_BREAK;
+            break;
+        }
+    }
+
+    if (bytes < 0) {
+        err = IoErr();
+    }
+
+    SetIoErr(err);
+    return (bytes == 0);
+}
+
+// Copy all the data of one filehandle to another.
+//
+// Reads and writes are sent as packets directly to the two handlers, with
+// two buffers, so the next read from the source overlaps the previous write
+// to the destination.
+//
+// If 'crc' is not NULL, the CRC-32 of the data is added to it. Each buffer
+// is checksummed while its write and the next read are in flight.
+static BOOL wbCopyData(struct Library *DOSBase, BPTR dstfh, BPTR srcfh, ULONG size, ULONG *crc, struct wbProgress *progress)
+{
+    ULONG buff_size = wbCopyBufferSize(size);
+    UBYTE *buff[2];
+    struct wbCopyPacket pkt[2] = { { NULL, FALSE }, { NULL, FALSE } };
+    struct MsgPort *port = NULL;
+    BOOL ok = FALSE;
+    LONG err = 0;
+
+    buff[0] = AllocVec(buff_size, MEMF_ANY);
+    buff[1] = AllocVec(buff_size, MEMF_ANY);
+    if (buff[0] == NULL) {
+        D(bug("%s: AllocVec(%ld, MEMF_ANY) = NULL\n", __func__, (IPTR)buff_size));
+        FreeVec(buff[1]);
+        SetIoErr(ERROR_NO_FREE_STORE);
+        return FALSE;
+    }
+
+    // Can we talk to the handlers directly? NIL: has no handler.
+    struct FileHandle *src_handle = BADDR(srcfh);
+    struct FileHandle *dst_handle = BADDR(dstfh);
+    BOOL async = (buff[1] != NULL && src_handle->fh_Type != NULL && dst_handle->fh_Type != NULL);
+    if (async) {
+        port = CreateMsgPort();
+        pkt[0].sp = AllocDosObject(DOS_STDPKT, NULL);
+        pkt[1].sp = AllocDosObject(DOS_STDPKT, NULL);
+        async = (port != NULL && pkt[0].sp != NULL && pkt[1].sp != NULL);
+    }
+
+    if (!async) {
+        ok = wbCopyDataSync(DOSBase, dstfh, srcfh, buff[0], buff_size, crc, progress);
+        err = IoErr();
+    } else {
+        struct wbCopyPacket *rd = &pkt[0];
+        struct wbCopyPacket *wr = &pkt[1];
+        int cur = 0;
+
+        wbCopyPacketSend(DOSBase, rd, port, ACTION_READ, srcfh, buff[cur], buff_size);
+        for (;;) {
+            LONG bytes = wbCopyPacketWait(DOSBase, pkt, 2, rd, port, &err);
+            if (bytes < 0) {
+                break;
+            }
+
+            // The previous write must be complete before its buffer is re-used.
+            if (wr->busy) {
+                LONG len = wr->sp->sp_Pkt.dp_Arg3;
+                if (wbCopyPacketWait(DOSBase, pkt, 2, wr, port, &err) != len) {
+                    if (err == 0) {
+                        err = ERROR_DISK_FULL;
+                    }
+                    break;
+                }
+                if (progress != NULL) {
+                    progress->wp_Bytes += len;
+                }
+            }
+
+            if (bytes == 0) {
+                // End of file, and everything is written.
+                ok = TRUE;
+                err = 0;
+                break;
+            }
+
+            if (wbProgressCancelled(DOSBase, progress)) {
+                err = ERROR_BREAK;
+                break;
+            }
+
+            wbCopyPacketSend(DOSBase, wr, port, ACTION_WRITE, dstfh, buff[cur], bytes);
+            cur ^= 1;
+            wbCopyPacketSend(DOSBase, rd, port, ACTION_READ, srcfh, buff[cur], buff_size);
+            if (crc != NULL) {
+                // The handler only reads from the buffer being written.
+                *crc = wbCrc32(*crc, buff[cur ^ 1], bytes);
+            }
+        }
+
+        // Don't leave any packets in flight.
+        LONG dummy;
+        wbCopyPacketWait(DOSBase, pkt, 2, rd, port, &dummy);
+        wbCopyPacketWait(DOSBase, pkt, 2, wr, port, &dummy);
+    }
+
+    if (pkt[1].sp != NULL) {
+        FreeDosObject(DOS_STDPKT, pkt[1].sp);
+    }
+    if (pkt[0].sp != NULL) {
+        FreeDosObject(DOS_STDPKT, pkt[0].sp);
+    }
+    if (port != NULL) {
+        DeleteMsgPort(port);
+    }
+    FreeVec(buff[1]);
+    FreeVec(buff[0]);
+
+    SetIoErr(err);
+    return ok;
+}
+
+static BOOL wbCopyLockCurrent(struct Library *DOSBase, CONST_STRPTR dst_file, BPTR src_lock, BOOL move, struct wbProgress *progress);
+
+// Is this copy only adding new or changed files?
+static inline BOOL wbCopySync(struct wbProgress *progress)
+{
+    return progress != NULL && (progress->wp_Flags & WBCOPYF_SYNC) != 0;
+}
+
+// Is this copy removing what it copied?
+static inline BOOL wbCopyMove(struct wbProgress *progress)
+{
+    return progress != NULL && (progress->wp_Flags & WBCOPYF_MOVE) != 0;
+}
+
+// Is this copy checking what it wrote? A move always does, as it
+// deletes each source once its copy is good.
+static inline BOOL wbCopyVerify(struct wbProgress *progress)
+{
+    return progress != NULL && (progress->wp_Flags & (WBCOPYF_VERIFY | WBCOPYF_MOVE)) != 0;
+}
+
+// CRC-32 of the rest of a file.
+static BOOL wbCopyCrcFile(struct Library *DOSBase, BPTR fh, ULONG size, ULONG *crc, struct wbProgress *progress)
+{
+    ULONG buff_size = wbCopyBufferSize(size);
+    UBYTE *buff = AllocVec(buff_size, MEMF_ANY);
+    LONG bytes;
+    LONG err = 0;
+
+    if (buff == NULL) {
+        SetIoErr(ERROR_NO_FREE_STORE);
+        return FALSE;
+    }
+
+    *crc = 0;
+    while ((bytes = Read(fh, buff, buff_size)) > 0) {
+        *crc = wbCrc32(*crc, buff, bytes);
+        if (wbProgressCancelled(DOSBase, progress)) {
+            err = ERROR_BREAK;
+            break;
+        }
+    }
+
+    if (bytes < 0) {
+        err = IoErr();
+    }
+
+    FreeVec(buff);
+
+    SetIoErr(err);
+    return (bytes == 0);
+}
+
+// CRC-32 of a locked file. The lock is kept.
+static BOOL wbCopyCrcLock(struct Library *DOSBase, BPTR lock, ULONG size, ULONG *crc, struct wbProgress *progress)
+{
+    BPTR dup = DupLock(lock);
+    if (dup == BNULL) {
+        return FALSE;
+    }
+
+    BPTR fh = OpenFromLock(dup);
+    if (fh == BNULL) {
+        LONG err = IoErr();
+        if (err != 0) {
+            // See the OpenFromLock() workaround in wbCopyFileLockCurrent().
+            UnLock(dup);
+        }
+        SetIoErr(err ? err : ERROR_OBJECT_NOT_FOUND);
+        return FALSE;
+    }
+
+    BOOL ok = wbCopyCrcFile(DOSBase, fh, size, crc, progress);
+    LONG err = IoErr();
+    Close(fh);
+
+    SetIoErr(err);
+    return ok;
+}
+
+// CRC-32 of a file here.
+static BOOL wbCopyCrcName(struct Library *DOSBase, CONST_STRPTR file, ULONG size, ULONG *crc, struct wbProgress *progress)
+{
+    BPTR fh = Open(file, MODE_OLDFILE);
+    if (fh == BNULL) {
+        return FALSE;
+    }
+
+    BOOL ok = wbCopyCrcFile(DOSBase, fh, size, crc, progress);
+    LONG err = IoErr();
+    Close(fh);
+
+    SetIoErr(err);
+    return ok;
+}
+
+// Is a lock on a directory?
+static BOOL wbLockIsDir(struct Library *DOSBase, BPTR lock)
+{
+    BOOL is_dir = FALSE;
+    struct FileInfoBlock *fib = AllocDosObjectTags(DOS_FIB, TAG_END);
+    if (fib != NULL) {
+        if (Examine(lock, fib)) {
+            is_dir = (fib->fib_DirEntryType >= 0);
+        }
+        FreeDosObject(DOS_FIB, fib);
+    }
+
+    return is_dir;
+}
+
+// Sync: is the existing destination file the same size and date as the source?
+// Returns FALSE, with ERROR_OBJECT_EXISTS, if the destination isn't a file.
+static BOOL wbCopySyncSame(struct Library *DOSBase, BPTR dst_lock, ULONG size, const struct DateStamp *date, BOOL *same)
+{
+    BOOL ok = FALSE;
+
+    *same = FALSE;
+
+    struct FileInfoBlock *fib = AllocDosObjectTags(DOS_FIB, TAG_END);
+    if (fib == NULL) {
+        SetIoErr(ERROR_NO_FREE_STORE);
+        return FALSE;
+    }
+
+    if (Examine(dst_lock, fib)) {
+        if (fib->fib_DirEntryType >= 0) {
+            SetIoErr(ERROR_OBJECT_EXISTS);
         } else {
-            // Copy the old file to the new location
-            BYTE *buff = AllocVec(buff_size, MEMF_ANY);
-            if (!buff) {
-                D(bug("%s: AllocVec(%ld, MEMF_ANY) = NULL\n", __func__, buff_size));
-                UnLock(src_lock);
-                err = ERROR_NO_FREE_STORE;
-                ok = FALSE;
-            } else {
-                BPTR srcfh = OpenFromLock(src_lock);
+            *same = ((ULONG)fib->fib_Size == size && CompareDates(&fib->fib_Date, date) == 0);
+            ok = TRUE;
+        }
+    }
+
+    FreeDosObject(DOS_FIB, fib);
+
+    return ok;
+}
+
+// Create a directory to copy into. If 'reuse' is set (when syncing or resuming),
+// an existing one is used instead.
+static BPTR wbCopyCreateDir(struct Library *DOSBase, CONST_STRPTR name, BOOL reuse)
+{
+    BPTR lock = CreateDir(name);
+    if (lock == BNULL && IoErr() == ERROR_OBJECT_EXISTS && reuse) {
+        lock = Lock(name, SHARED_LOCK);
+        if (lock != BNULL && !wbLockIsDir(DOSBase, lock)) {
+            UnLock(lock);
+            lock = BNULL;
+            SetIoErr(ERROR_OBJECT_EXISTS);
+        }
+    }
+
+    return lock;
+}
+
+// Journal of a drawer copy, kept in the destination drawer while its
+// contents are copied, and deleted once they all are. If the copy is
+// interrupted, copying the drawer there again skips what the journal
+// says is done, and resumes the partly copied file.
+//
+// Each line is "D <path>" for a finished entry, or
+// "P <offset> <size> <days> <mins> <ticks> <path>" for a file that was
+// copied up to 'offset', from a source of that size and date. Paths are
+// relative to the drawer. A journal started by a move begins with an "M"
+// line; only then were its finished entries verified before being noted,
+// so only then may a resumed move delete their sources.
+#define WBCOPY_JOURNAL          ".copy-journal"
+#define WBCOPY_JOURNAL_HASH     64
+#define WBCOPY_JOURNAL_FLUSH    16  // Entries between flushes.
+
+struct wbJournalEntry {
+    struct MinNode wje_Node;
+    STRPTR         wje_Path;
+};
+
+struct wbCopyJournal {
+    BPTR           wcj_File;    // Open for appending, or BNULL.
+    BOOL           wcj_Resume;  // Resuming an interrupted copy.
+    BOOL           wcj_Move;    // The journal was started by a move.
+    ULONG          wcj_Pending; // Entries written since the last flush.
+    struct MinList wcj_Done[WBCOPY_JOURNAL_HASH]; // Entries finished by the interrupted copy.
+    STRPTR         wcj_Partial; // File partly copied by the interrupted copy, or NULL.
+    ULONG          wcj_Offset;  // ...and how much of it was,
+    ULONG          wcj_Size;    // ...from a source of this size
+    struct DateStamp wcj_Date;  // ...and date.
+    ULONG          wcj_Lost;    // Directory levels too deep for wcj_Dir.
+    TEXT           wcj_Dir[PATH_MAX];   // Directory being copied, relative to the drawer.
+    TEXT           wcj_Name[PATH_MAX];  // Scratch for wbJournalPath().
+};
+
+// Does a destination drawer have the journal of an interrupted copy?
+static BOOL wbJournalExists(struct Library *DOSBase, CONST_STRPTR dir)
+{
+    BOOL exists = FALSE;
+    LONG len = STRLEN(dir) + 1 + STRLEN(WBCOPY_JOURNAL) + 1;
+    STRPTR path = AllocVec(len, MEMF_ANY);
+    if (path != NULL) {
+        CopyMem(dir, path, STRLEN(dir) + 1);
+        if (AddPart(path, WBCOPY_JOURNAL, len)) {
+            BPTR lock = Lock(path, SHARED_LOCK);
+            exists = (lock != BNULL);
+            UnLock(lock);
+        }
+        FreeVec(path);
+    }
+
+    return exists;
+}
+
+static ULONG wbJournalHash(CONST_STRPTR path)
+{
+    ULONG hash = 0;
+
+    for (; *path != 0; path++) {
+        hash = hash * 31 + wbNameFold(*path);
+    }
+
+    return hash % WBCOPY_JOURNAL_HASH;
+}
+
+// Path of an entry in the directory being copied, relative to the drawer.
+static CONST_STRPTR wbJournalPath(struct Library *DOSBase, struct wbCopyJournal *wcj, CONST_STRPTR name)
+{
+    if (wcj->wcj_Lost > 0) {
+        return NULL;
+    }
+
+    CopyMem(wcj->wcj_Dir, wcj->wcj_Name, STRLEN(wcj->wcj_Dir) + 1);
+    if (!AddPart(wcj->wcj_Name, name, sizeof(wcj->wcj_Name))) {
+        return NULL;
+    }
+
+    return wcj->wcj_Name;
+}
+
+// The copy goes down into a directory.
+static void wbJournalEnter(struct Library *DOSBase, struct wbCopyJournal *wcj, CONST_STRPTR name)
+{
+    if (wcj == NULL) {
+        return;
+    }
+
+    if (wcj->wcj_Lost > 0 || !AddPart(wcj->wcj_Dir, name, sizeof(wcj->wcj_Dir))) {
+        wcj->wcj_Lost++;
+    }
+}
+
+// The copy comes back up out of a directory.
+static void wbJournalLeave(struct Library *DOSBase, struct wbCopyJournal *wcj)
+{
+    if (wcj == NULL) {
+        return;
+    }
+
+    if (wcj->wcj_Lost > 0) {
+        wcj->wcj_Lost--;
+    } else {
+        *PathPart(wcj->wcj_Dir) = 0;
+    }
+}
+
+static void wbJournalNoteDone(struct wbCopyJournal *wcj, CONST_STRPTR path)
+{
+    LONG len = STRLEN(path) + 1;
+    struct wbJournalEntry *wje = AllocVec(sizeof(*wje) + len, MEMF_ANY);
+    if (wje == NULL) {
+        // Not fatal - the entry is just copied again.
+        return;
+    }
+
+    wje->wje_Path = (STRPTR)&wje[1];
+    CopyMem(path, wje->wje_Path, len);
+    AddTail((struct List *)&wcj->wcj_Done[wbJournalHash(path)], (struct Node *)&wje->wje_Node);
+}
+
+// Read the journal of an interrupted copy. CurrentDir() is the drawer.
+static void wbJournalRead(struct Library *DOSBase, struct wbCopyJournal *wcj)
+{
+    BPTR fh = Open(WBCOPY_JOURNAL, MODE_OLDFILE);
+    if (fh == BNULL) {
+        return;
+    }
+
+    STRPTR line = wcj->wcj_Name;
+    while (FGets(fh, line, sizeof(wcj->wcj_Name)) != NULL) {
+        LONG len = STRLEN(line);
+        if (len > 0 && line[len-1] == '\n') {
+            line[--len] = 0;
+        }
+        if (len == 1 && line[0] == 'M') {
+            wcj->wcj_Move = TRUE;
+            continue;
+        }
+        if (len < 3 || line[1] != ' ') {
+            continue;
+        }
+
+        if (line[0] == 'D') {
+            CONST_STRPTR path = &line[2];
+            if (wcj->wcj_Partial != NULL && wbNameSame(wcj->wcj_Partial, path)) {
+                FreeVec(wcj->wcj_Partial);
+                wcj->wcj_Partial = NULL;
+            }
+            wbJournalNoteDone(wcj, path);
+        } else if (line[0] == 'P') {
+            // Offset, size, days, minutes and ticks.
+            LONG value[5];
+            CONST_STRPTR cp = &line[1];
+            int n;
+            for (n = 0; n < 5 && *cp == ' '; n++) {
+                LONG used = StrToLong(cp + 1, &value[n]);
+                if (used <= 0) {
+                    break;
+                }
+                cp += 1 + used;
+            }
+            if (n == 5 && *cp == ' ' && value[0] > 0) {
+                FreeVec(wcj->wcj_Partial);
+                wcj->wcj_Partial = StrDup(cp + 1);
+                wcj->wcj_Offset = value[0];
+                wcj->wcj_Size = value[1];
+                wcj->wcj_Date.ds_Days = value[2];
+                wcj->wcj_Date.ds_Minute = value[3];
+                wcj->wcj_Date.ds_Tick = value[4];
+            }
+        }
+    }
+
+    Close(fh);
+}
+
+static void wbJournalWrite(struct Library *DOSBase, struct wbCopyJournal *wcj, CONST_STRPTR line, CONST_STRPTR path, BOOL flush);
+
+// Start the journal of a copy into 'dir'. Without a journal the copy
+// still works, it just can't be resumed.
+static struct wbCopyJournal *wbJournalOpen(struct Library *DOSBase, BPTR dir, BOOL resume, BOOL move)
+{
+    struct wbCopyJournal *wcj = AllocVec(sizeof(*wcj), MEMF_ANY | MEMF_CLEAR);
+    if (wcj == NULL) {
+        return NULL;
+    }
+
+    for (int i = 0; i < WBCOPY_JOURNAL_HASH; i++) {
+        NEWLIST(&wcj->wcj_Done[i]);
+    }
+    wcj->wcj_Resume = resume;
+
+    BPTR pwd = CurrentDir(dir);
+    if (resume) {
+        wbJournalRead(DOSBase, wcj);
+        wcj->wcj_File = Open(WBCOPY_JOURNAL, MODE_READWRITE);
+        if (wcj->wcj_File != BNULL) {
+            Seek(wcj->wcj_File, 0, OFFSET_END);
+        }
+    } else {
+        wcj->wcj_File = Open(WBCOPY_JOURNAL, MODE_NEWFILE);
+        if (wcj->wcj_File != BNULL && move) {
+            wbJournalWrite(DOSBase, wcj, "M", "", TRUE);
+        }
+    }
+    CurrentDir(pwd);
+
+    D(if (wcj->wcj_File == BNULL) bug("%s: Can't open %s|%s: %ld\n", __func__, sLOCKNAME(dir), WBCOPY_JOURNAL, IoErr()));
+
+    return wcj;
+}
+
+// Finish the journal. It is only deleted if the copy is complete.
+static void wbJournalClose(struct Library *DOSBase, struct wbCopyJournal *wcj, BPTR dir, BOOL complete)
+{
+    if (wcj == NULL) {
+        return;
+    }
+
+    if (wcj->wcj_File != BNULL) {
+        Close(wcj->wcj_File);
+        if (complete) {
+            BPTR pwd = CurrentDir(dir);
+            DeleteFile(WBCOPY_JOURNAL);
+            CurrentDir(pwd);
+        }
+    }
+
+    for (int i = 0; i < WBCOPY_JOURNAL_HASH; i++) {
+        struct wbJournalEntry *wje;
+        while ((wje = (struct wbJournalEntry *)RemHead((struct List *)&wcj->wcj_Done[i])) != NULL) {
+            FreeVec(wje);
+        }
+    }
+    FreeVec(wcj->wcj_Partial);
+    FreeVec(wcj);
+}
+
+// Did the interrupted copy finish this entry?
+static BOOL wbJournalIsDone(struct Library *DOSBase, struct wbCopyJournal *wcj, CONST_STRPTR name)
+{
+    if (wcj == NULL || !wcj->wcj_Resume) {
+        return FALSE;
+    }
+
+    CONST_STRPTR path = wbJournalPath(DOSBase, wcj, name);
+    if (path == NULL) {
+        return FALSE;
+    }
+
+    struct wbJournalEntry *wje;
+    ForeachNode(&wcj->wcj_Done[wbJournalHash(path)], wje) {
+        if (wbNameSame(wje->wje_Path, path)) {
+            // Each entry is only visited once.
+            REMOVE((struct Node *)&wje->wje_Node);
+            FreeVec(wje);
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+// How much of this file did the interrupted copy write? Nothing, if the
+// source has changed since, as what was written is then of no use.
+static ULONG wbJournalResumeOffset(struct Library *DOSBase, struct wbCopyJournal *wcj, CONST_STRPTR name, ULONG size, const struct DateStamp *date)
+{
+    if (wcj == NULL || wcj->wcj_Partial == NULL) {
+        return 0;
+    }
+
+    CONST_STRPTR path = wbJournalPath(DOSBase, wcj, name);
+    if (path == NULL || !wbNameSame(wcj->wcj_Partial, path)) {
+        return 0;
+    }
+
+    if (wcj->wcj_Size != size || CompareDates(&wcj->wcj_Date, date) != 0) {
+        D(bug("%s: '%s' has changed since it was partly copied\n", __func__, path));
+        return 0;
+    }
+
+    return wcj->wcj_Offset;
+}
+
+static void wbJournalWrite(struct Library *DOSBase, struct wbCopyJournal *wcj, CONST_STRPTR line, CONST_STRPTR path, BOOL flush)
+{
+    if (FPuts(wcj->wcj_File, line) != 0 || FPuts(wcj->wcj_File, path) != 0 || FPutC(wcj->wcj_File, '\n') < 0) {
+        // Stop journaling, rather than leave a journal with holes in it.
+        D(bug("%s: Can't write journal: %ld\n", __func__, IoErr()));
+        Close(wcj->wcj_File);
+        wcj->wcj_File = BNULL;
+        return;
+    }
+
+    // Keep the journal reasonably current, without a write for every small file.
+    if (flush || ++wcj->wcj_Pending >= WBCOPY_JOURNAL_FLUSH) {
+        Flush(wcj->wcj_File);
+        wcj->wcj_Pending = 0;
+    }
+}
+
+// Record that an entry is done.
+static void wbJournalDone(struct Library *DOSBase, struct wbCopyJournal *wcj, CONST_STRPTR name)
+{
+    if (wcj == NULL || wcj->wcj_File == BNULL) {
+        return;
+    }
+
+    CONST_STRPTR path = wbJournalPath(DOSBase, wcj, name);
+    if (path != NULL) {
+        wbJournalWrite(DOSBase, wcj, "D ", path, FALSE);
+    }
+}
+
+// Record how much of a file was copied before the copy stopped, and
+// the size and date of its source, so a changed source isn't resumed.
+static void wbJournalPartial(struct Library *DOSBase, struct wbCopyJournal *wcj, CONST_STRPTR name, ULONG offset, ULONG size, const struct DateStamp *date)
+{
+    if (wcj == NULL || wcj->wcj_File == BNULL) {
+        return;
+    }
+
+    CONST_STRPTR path = wbJournalPath(DOSBase, wcj, name);
+    if (path != NULL) {
+        TEXT line[64];
+        snprintf(line, sizeof(line), "P %lu %lu %ld %ld %ld ",
+                 (unsigned long)offset, (unsigned long)size,
+                 (long)date->ds_Days, (long)date->ds_Minute, (long)date->ds_Tick);
+        line[sizeof(line)-1] = 0;
+        wbJournalWrite(DOSBase, wcj, line, path, TRUE);
+    }
+}
+
+// Copy a single file to here.
+//
+// Normally an existing destination is an error. When syncing, an existing
+// file with the same size and date is left alone, and a different one is
+// replaced. Synced copies keep the source's date, so the next sync can
+// tell they are the same.
+//
+// With a 'journal', a failed copy leaves what it wrote behind, and notes
+// how much that was. When resuming, existing files are replaced, and the
+// file the journal says was partly copied continues from where it stopped.
+//
+// NOTE: This routine _eats_ src_lock!
+static BOOL wbCopyFileLockCurrent(struct Library *DOSBase, CONST_STRPTR dst_file, BPTR src_lock, ULONG size, const struct DateStamp *date, struct wbCopyJournal *journal, struct wbProgress *progress)
+{
+    BOOL ok = FALSE;
+    LONG err = 0;
+
+    BPTR dst_lock = Lock(dst_file, SHARED_LOCK);
+    if (dst_lock != BNULL) {
+        BOOL same = FALSE;
+        if (wbCopySync(progress)) {
+            ok = wbCopySyncSame(DOSBase, dst_lock, size, date, &same);
+            err = IoErr();
+        } else if (journal != NULL && journal->wcj_Resume) {
+            // Left over from the interrupted copy.
+            ok = TRUE;
+        } else {
+            // Don't copy on top of an existing object.
+            D(bug("%s: '%s' already exists in target\n", __func__, dst_file));
+            err = ERROR_OBJECT_EXISTS;
+        }
+        UnLock(dst_lock);
+
+        if (ok && same && wbCopyVerify(progress)) {
+            // Size and date can lie. Compare the contents too.
+            ULONG src_crc, dst_crc;
+            ok = wbCopyCrcLock(DOSBase, src_lock, size, &src_crc, progress) &&
+                 wbCopyCrcName(DOSBase, dst_file, size, &dst_crc, progress);
+            err = IoErr();
+            same = ok && (src_crc == dst_crc);
+        }
+
+        if (!ok || same) {
+            D(if (same) bug("%s: '%s' is up to date\n", __func__, dst_file));
+            UnLock(src_lock);
+            SetIoErr(err);
+            return ok;
+        }
+    }
+
+    // Copy the old file to the new location
+    BPTR srcfh = OpenFromLock(src_lock);
+    err = IoErr();
+    if (srcfh == BNULL) {
+        D(bug("%s: OpenFromLock(%s): %ld\n", __func__, sLOCKNAME(src_lock), IoErr()));
+        if (err != 0) {
+            // WORKAROUND: Some AROS kernels have a bug where OpenFromLock() succeeds, yet
+            //             returns an BNULL filehandle! If (fh = BNULL, IoErr() == 0), don't UnLock()!
+            UnLock(src_lock);
+        }
+    } else {
+        BPTR dstfh = BNULL;
+
+        // Pick up where an interrupted copy stopped. A verified copy has
+        // to checksum all of the source, so it starts again instead.
+        ULONG offset = wbCopyVerify(progress) ? 0 : wbJournalResumeOffset(DOSBase, journal, dst_file, size, date);
+        if (offset > 0 && offset <= size) {
+            dstfh = Open(dst_file, MODE_OLDFILE);
+            if (dstfh != BNULL && (Seek(dstfh, offset, OFFSET_BEGINNING) < 0 || Seek(srcfh, offset, OFFSET_BEGINNING) < 0)) {
+                // Shorter than the journal says. Start again.
+                Close(dstfh);
+                dstfh = BNULL;
+                Seek(srcfh, 0, OFFSET_BEGINNING);
+            }
+            D(if (dstfh != BNULL) bug("%s: Resuming '%s' at %ld\n", __func__, dst_file, (IPTR)offset));
+        }
+        if (dstfh == BNULL) {
+            offset = 0;
+            dstfh = Open(dst_file, MODE_NEWFILE);
+        }
+        err = IoErr();
+        ok = (dstfh != BNULL);
+        D(if (!ok) bug("%s: Open: %ld\n", __func__, IoErr()));
+        if (ok) {
+            // Preallocate the destination, so the filesystem can lay it out in one go.
+            // Not all handlers support this, and that's fine.
+            BOOL preallocated = FALSE;
+            if (offset == 0 && size > WBCOPY_BUFFER_MIN && SetFileSize(dstfh, size, OFFSET_BEGINNING) == (LONG)size) {
+                Seek(dstfh, 0, OFFSET_BEGINNING);
+                preallocated = TRUE;
+            }
+
+            ULONG crc = 0;
+            ok = wbCopyData(DOSBase, dstfh, srcfh, size - offset, wbCopyVerify(progress) ? &crc : NULL, progress);
+            err = IoErr();
+            D(if (!ok) bug("%s: Copy: %ld\n", __func__, (IPTR)err));
+            if (ok && preallocated) {
+                // In case the source shrank while we were copying it.
+                SetFileSize(dstfh, 0, OFFSET_CURRENT);
+            }
+            LONG written = 0;
+            if (!ok && journal != NULL && journal->wcj_File != BNULL) {
+                // Keep what was written, for the next attempt.
+                written = Seek(dstfh, 0, OFFSET_CURRENT);
+                if (written > 0) {
+                    SetFileSize(dstfh, 0, OFFSET_CURRENT);
+                }
+            }
+            Close(dstfh);
+            if (ok && wbCopyVerify(progress)) {
+                // Read back what was written, now that it has left the buffers.
+                ULONG dst_crc;
+                ok = wbCopyCrcName(DOSBase, dst_file, size, &dst_crc, progress);
                 err = IoErr();
-                if (srcfh == BNULL) {
-                    D(bug("%s: OpenFromLock(%s): %ld\n", __func__, sLOCKNAME(src_lock), IoErr()));
-                    if (err != 0) {
-                        // WORKAROUND: Some AROS kernels have a bug where OpenFromLock() succeeds, yet
-                        //             returns an BNULL filehandle! If (fh = BNULL, IoErr() == 0), don't UnLock()!
-                        UnLock(src_lock);
-                    }
-                } else {
-                    BPTR dst_lock = Lock(dst_file, SHARED_LOCK);
-                    if (dst_lock != BNULL) {
-                        // Don't copy on top of an existing object.
-                        D(bug("%s: '%s' already exists in target\n", __func__, dst_file));
-                        UnLock(dst_lock);
-                        SetIoErr(ERROR_OBJECT_EXISTS);
-                        ok = FALSE;
-                    } else {
-                        BPTR dstfh = Open(dst_file, MODE_NEWFILE);
-                        err = IoErr();
-                        ok = (dstfh != BNULL);
-                        D(if (!ok) bug("%s: Open: %ld\n", __func__, IoErr()));
-                        if (ok) {
-                            LONG bytes;
-                            while ((bytes = Read(srcfh, buff, buff_size)) > 0) {
-                                LONG copied = Write(dstfh, buff, buff_size);
-                                if (copied < 0) {
-                                    err = IoErr();
-                                    break;
-                                }
-                            }
-
-                            // Did we copy everything?
-                            ok = (bytes == 0);
-                            D(if (!ok) bug("%s: Copy: %ld\n", __func__, IoErr()));
-                            Close(dstfh);
-                            if (!ok) {
-                                // Clean up our mess.
-                                DeleteFile(dst_file);
-                            }
-                        }
+                if (ok && dst_crc != crc) {
+                    D(bug("%s: '%s' does not verify (%08lx != %08lx)\n", __func__, dst_file, (IPTR)dst_crc, (IPTR)crc));
+                    progress->wp_Mismatched++;
+                    ok = FALSE;
+                    err = WBERROR_VERIFY;
+                } else if (ok) {
+                    progress->wp_Verified++;
+                }
+            }
+            if (!ok && written > 0) {
+                wbJournalPartial(DOSBase, journal, dst_file, written, size, date);
+            } else if (!ok) {
+                // Clean up our mess.
+                DeleteFile(dst_file);
+            } else if (wbCopySync(progress)) {
+                SetFileDate(dst_file, (struct DateStamp *)date);
+            }
+        }
+        Close(srcfh);
+    }
+
+    SetIoErr(err);
+    return ok;
+}
+
+// The target of a soft link here, or NULL (with IoErr() set) if 'name'
+// isn't one. FreeVec() it when done.
+static STRPTR wbSoftLinkTargetCurrent(struct Library *DOSBase, CONST_STRPTR name)
+{
+    BPTR pwd = CurrentDir(BNULL);
+    CurrentDir(pwd);
+
+    struct FileLock *fl = BADDR(pwd);
+    struct MsgPort *port = (fl != NULL) ? fl->fl_Task : GetFileSysTask();
+
+    STRPTR target = AllocVec(PATH_MAX, MEMF_ANY);
+    if (target == NULL) {
+        SetIoErr(ERROR_NO_FREE_STORE);
+        return NULL;
+    }
+
+    if (!ReadLink(port, pwd, name, target, PATH_MAX)) {
+        LONG err = IoErr();
+        FreeVec(target);
+        SetIoErr(err);
+        return NULL;
+    }
+
+    return target;
+}
+
+// Make a soft link here. With 'replace', a link left by an earlier
+// copy is replaced.
+static BOOL wbMakeSoftLinkCurrent(struct Library *DOSBase, CONST_STRPTR name, CONST_STRPTR target, BOOL replace)
+{
+    BOOL ok = MakeLink(name, (SIPTR)target, LINK_SOFT);
+    if (!ok && replace && IoErr() == ERROR_OBJECT_EXISTS && DeleteFile(name)) {
+        ok = MakeLink(name, (SIPTR)target, LINK_SOFT);
+    }
+
+    return ok;
+}
+
+// A destination directory on the copy stack.
+struct wbCopyDir {
+    struct MinNode wcd_Node;
+    BPTR           wcd_Lock;
+};
+
+// State of a directory copy. The head of wcw_Dirs is the
+// destination of the source directory being walked.
+struct wbCopyWalk {
+    struct MinList        wcw_Dirs;
+    struct wbCopyJournal *wcw_Journal;  // May be NULL.
+    BOOL                  wcw_Move;     // Delete each source entry once it is copied.
+    struct wbProgress    *wcw_Progress;
+};
+
+// Copy walk: create directories and copy files on the way down.
+// When moving, each file is deleted as soon as it is copied (and verified).
+static LONG wbCopyWalkPre(struct Library *DOSBase, struct ExAllData *ead, APTR arg)
+{
+    struct wbCopyWalk *wcw = arg;
+    struct wbCopyDir *dst = (struct wbCopyDir *)GetHead((struct List *)&wcw->wcw_Dirs);
+    struct wbCopyJournal *wcj = wcw->wcw_Journal;
+    BOOL ok;
+    LONG err;
+
+    if (wcj != NULL) {
+        if (wcj->wcj_Dir[0] == 0 && wbNameSame(ead->ed_Name, WBCOPY_JOURNAL)) {
+            // Don't copy a journal on top of our own.
+            return WBWALK_SKIP;
+        }
+        if (wbJournalIsDone(DOSBase, wcj, ead->ed_Name)) {
+            if (!wcw->wcw_Move || wcj->wcj_Move) {
+                D(bug("%s: '%s' was already copied\n", __func__, ead->ed_Name));
+                if (wcw->wcw_Move) {
+                    // The interrupted move verified it, but may have
+                    // stopped before deleting it.
+                    DeleteFile(ead->ed_Name);
+                }
+                if (wcw->wcw_Progress != NULL) {
+                    wcw->wcw_Progress->wp_Files++;
+                }
+                return WBWALK_SKIP;
+            }
+            // Done by a plain copy, which didn't verify it, so copy it
+            // again before its source is deleted.
+            D(bug("%s: '%s' was copied, but not by a move\n", __func__, ead->ed_Name));
+        }
+    }
+
+    if (wcw->wcw_Move && ead->ed_Type == ST_SOFTLINK) {
+        // Following the link would copy what it points to, and then
+        // delete only the link. Move the link itself instead.
+        STRPTR target = wbSoftLinkTargetCurrent(DOSBase, ead->ed_Name);
+        ok = (target != NULL);
+        err = IoErr();
+        if (ok) {
+            BPTR pwd = CurrentDir(dst->wcd_Lock);
+            ok = wbMakeSoftLinkCurrent(DOSBase, ead->ed_Name, target, wbCopySync(wcw->wcw_Progress) || (wcj != NULL && wcj->wcj_Resume));
+            err = IoErr();
+            if (ok) {
+                wbJournalDone(DOSBase, wcj, ead->ed_Name);
+            }
+            CurrentDir(pwd);
+            FreeVec(target);
+        }
+        if (ok) {
+            if (wcw->wcw_Progress != NULL) {
+                wcw->wcw_Progress->wp_Files++;
+            }
+            ok = DeleteFile(ead->ed_Name);
+            err = IoErr();
+        }
+        SetIoErr(err);
+        return ok ? WBWALK_CONTINUE : WBWALK_STOP;
+    }
+
+    if (wbWalkIsDir(ead)) {
+        BPTR pwd = CurrentDir(dst->wcd_Lock);
+        BPTR lock = wbCopyCreateDir(DOSBase, ead->ed_Name, wbCopySync(wcw->wcw_Progress) || (wcj != NULL && wcj->wcj_Resume));
+        err = IoErr();
+        CurrentDir(pwd);
+        if (lock == BNULL) {
+            D(bug("%s: CreateDir(%s): %ld\n", __func__, ead->ed_Name, (IPTR)err));
+            SetIoErr(err);
+            return WBWALK_STOP;
+        }
+
+        struct wbCopyDir *wcd = AllocVec(sizeof(*wcd), MEMF_ANY);
+        if (wcd == NULL) {
+            UnLock(lock);
+            SetIoErr(ERROR_NO_FREE_STORE);
+            return WBWALK_STOP;
+        }
+        wcd->wcd_Lock = lock;
+        AddHead((struct List *)&wcw->wcw_Dirs, (struct Node *)&wcd->wcd_Node);
+        wbJournalEnter(DOSBase, wcj, ead->ed_Name);
+
+        return WBWALK_CONTINUE;
+    }
+
+    BPTR lock = Lock(ead->ed_Name, SHARED_LOCK);
+    if (lock == BNULL) {
+        D(bug("%s: Can't lock %s|%s\n", __func__, sCURRDIR(), ead->ed_Name));
+        return WBWALK_STOP;
+    }
+
+    BPTR pwd = CurrentDir(dst->wcd_Lock);
+    if (ead->ed_Type < 0) {
+        // Plain files are copied straight from the ExAll() data.
+        struct DateStamp date = { ead->ed_Days, ead->ed_Mins, ead->ed_Ticks };
+        ok = wbCopyFileLockCurrent(DOSBase, ead->ed_Name, lock, ead->ed_Size, &date, wcj, wcw->wcw_Progress);
+        if (ok) {
+            ok = SetProtection(ead->ed_Name, ead->ed_Prot);
+            if (ok && wcw->wcw_Progress != NULL) {
+                wcw->wcw_Progress->wp_Files++;
+            }
+        }
+    } else {
+        // Links are followed, and their target is copied. When moving,
+        // this is only a hard linked drawer: its contents are still in
+        // the drawer it links to, so only the link itself is deleted.
+        ok = wbCopyLockCurrent(DOSBase, ead->ed_Name, lock, FALSE, wcw->wcw_Progress);
+    }
+    err = IoErr();
+    if (ok) {
+        wbJournalDone(DOSBase, wcj, ead->ed_Name);
+    }
+    CurrentDir(pwd);
+
+    if (ok && wcw->wcw_Move) {
+        ok = DeleteFile(ead->ed_Name);
+        err = IoErr();
+        D(if (!ok) bug("%s: Can't delete %s|%s: %ld\n", __func__, sCURRDIR(), ead->ed_Name, (IPTR)err));
+    }
+
+    SetIoErr(err);
+    return ok ? WBWALK_CONTINUE : WBWALK_STOP;
+}
+
+// Copy walk: set the protection of directories once they are filled.
+// When moving, the source directory is empty by now, and is deleted.
+static LONG wbCopyWalkPost(struct Library *DOSBase, struct ExAllData *ead, APTR arg)
+{
+    struct wbCopyWalk *wcw = arg;
+    struct wbCopyDir *wcd = (struct wbCopyDir *)RemHead((struct List *)&wcw->wcw_Dirs);
+    struct wbCopyDir *dst = (struct wbCopyDir *)GetHead((struct List *)&wcw->wcw_Dirs);
+
+    UnLock(wcd->wcd_Lock);
+    FreeVec(wcd);
+    wbJournalLeave(DOSBase, wcw->wcw_Journal);
+
+    BPTR pwd = CurrentDir(dst->wcd_Lock);
+    BOOL ok = SetProtection(ead->ed_Name, ead->ed_Prot);
+    LONG err = IoErr();
+    CurrentDir(pwd);
+
+    if (ok && wcw->wcw_Move) {
+        ok = DeleteFile(ead->ed_Name);
+        err = IoErr();
+    }
+
+    if (ok) {
+        wbJournalDone(DOSBase, wcw->wcw_Journal, ead->ed_Name);
+        if (wcw->wcw_Progress != NULL) {
+            wcw->wcw_Progress->wp_Files++;
+        }
+    }
+
+    SetIoErr(err);
+    return ok ? WBWALK_CONTINUE : WBWALK_STOP;
+}
+
+// Copy a single file/directory to here.
+// Does NOT take special care for .icon files!
+// If 'move' is set, the contents of a directory are deleted as they are copied,
+// but the caller deletes the source itself.
+// NOTE: This routine _eats_ src_lock!
+static BOOL wbCopyLockCurrent(struct Library *DOSBase, CONST_STRPTR dst_file, BPTR src_lock, BOOL move, struct wbProgress *progress)
+{
+    ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
+
+    BOOL ok = FALSE;
+    LONG err = 0;
+
+    struct FileInfoBlock *fib = AllocDosObjectTags(DOS_FIB, TAG_END);
+    if (!fib) {
+        D(bug("%s: Can't allocate FIB\n", __func__));
+        UnLock(src_lock);
+        return FALSE;
+    }
+
+    // Examine the lock to see what it is.
+    ok = Examine(src_lock, fib);
+    if (ok) {
+        // Cache attributes we may need later.
+        LONG protection = fib->fib_Protection;
+        ULONG size = fib->fib_Size;
+        struct DateStamp date = fib->fib_Date;
+
+        ok = FALSE;
+        if (fib->fib_DirEntryType>=0) {
+            // Directory copies. A drawer with a journal in it is
+            // from an interrupted copy, and is picked up again.
+            BOOL resume = wbJournalExists(DOSBase, dst_file);
+            BPTR dst_lock = wbCopyCreateDir(DOSBase, dst_file, resume || wbCopySync(progress));
+            err = IoErr();
+            if (dst_lock != BNULL) {
+                struct wbCopyWalk wcw;
+                struct wbCopyDir top, *wcd;
+
+                NEWLIST(&wcw.wcw_Dirs);
+                wcw.wcw_Journal = wbJournalOpen(DOSBase, dst_lock, resume, move);
+                wcw.wcw_Move = move;
+                wcw.wcw_Progress = progress;
+                top.wcd_Lock = dst_lock;
+                AddHead((struct List *)&wcw.wcw_Dirs, (struct Node *)&top.wcd_Node);
+
+                // Copy all the files in src_lock to dst_lock
+                ok = wbWalkLock(src_lock, wbCopyWalkPre, wbCopyWalkPost, &wcw, progress);
+                err = IoErr();
+                wbJournalClose(DOSBase, wcw.wcw_Journal, dst_lock, ok);
+
+                // Unwind whatever a failure left behind.
+                while ((wcd = (struct wbCopyDir *)RemHead((struct List *)&wcw.wcw_Dirs)) != NULL) {
+                    UnLock(wcd->wcd_Lock);
+                    if (wcd != &top) {
+                        FreeVec(wcd);
                     }
-                    Close(srcfh);
                 }
-                FreeVec(buff);
+            } else {
+                D(bug("%s: CreateDir(%s): %ld\n", __func__, dst_file, (IPTR)err));
             }
+            UnLock(src_lock);
+        } else {
+            ok = wbCopyFileLockCurrent(DOSBase, dst_file, src_lock, size, &date, NULL, progress);
+            err = IoErr();
         }
 
         // Copy protection.
         if (ok) {
             ok = SetProtection(dst_file, protection);
             err = IoErr();
+            if (ok && progress != NULL) {
+                progress->wp_Files++;
+            }
         }
     } else {
         UnLock(src_lock);
@@ -423,12 +1919,13 @@ static BOOL wbCopyLockCurrent(struct Library *DOSBase, CONST_STRPTR dst_file, BP
 }
 
 // Copy into the same directory, bumping the 'Copy_of_...' prefix as needed.
-BOOL _wbCopyBumpCurrent(struct Library *DOSBase, struct Library *IconBase, CONST_STRPTR src_file)
+BOOL _wbCopyBumpCurrent(struct Library *DOSBase, struct Library *IconBase, CONST_STRPTR src_file, struct wbBumpCache *cache, struct wbProgress *progress)
 {
     ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
 
     BOOL ok = TRUE;
     LONG err = 0;
+    struct wbBumpCache local;
 
     // Compute the new name
     char *dst_file = AllocVec(FILENAME_MAX, MEMF_ANY);
@@ -437,7 +1934,17 @@ BOOL _wbCopyBumpCurrent(struct Library *DOSBase, struct Library *IconBase, CONST
         return FALSE;
     }
 
-    if (!wbBumpRevisionCurrent(DOSBase, src_file, dst_file)) {
+    if (cache == NULL) {
+        wbBumpCacheInit(&local);
+    }
+
+    ok = wbBumpRevisionCurrent(DOSBase, cache ? cache : &local, src_file, dst_file);
+
+    if (cache == NULL) {
+        wbBumpCacheFree(&local);
+    }
+
+    if (!ok) {
         D(bug("%s: Can't bump version of '%s'\n", __func__, src_file));
         FreeVec(dst_file);
         return FALSE;
@@ -462,7 +1969,7 @@ BOOL _wbCopyBumpCurrent(struct Library *DOSBase, struct Library *IconBase, CONST
         err = IoErr();
         D(if (src_lock == BNULL) bug("%s: Lock('%s', SHARED_LOCK): %ld\n", __func__, src_file, IoErr()));
         if (src_lock != BNULL) {
-            ok = wbCopyLockCurrent(DOSBase, dst_file, src_lock);
+            ok = wbCopyLockCurrent(DOSBase, dst_file, src_lock, FALSE, progress);
             err = IoErr();
             D(if (!ok) bug("%s: Top level %s|%s copy to %s - (%ld)\n", __func__, sCURRDIR(), src_file, dst_file, (IPTR)err));
         }
@@ -474,20 +1981,159 @@ BOOL _wbCopyBumpCurrent(struct Library *DOSBase, struct Library *IconBase, CONST
     return ok;
 }
 
-// Copy into this directory, respecting icons
-BOOL _wbCopyIntoCurrentAt(struct Library *DOSBase, struct Library *IconBase, BPTR src_dir, CONST_STRPTR src_file, LONG targetX, LONG targetY)
+// Does a file here have an icon?
+static BOOL wbIconExistsCurrent(struct Library *DOSBase, CONST_STRPTR file)
+{
+    BOOL exists = FALSE;
+    LONG len = STRLEN(file) + 5 + 1;
+    STRPTR info = AllocVec(len, MEMF_ANY);
+    if (info != NULL) {
+        snprintf(info, len, "%s.info", file);
+        BPTR lock = Lock(info, SHARED_LOCK);
+        exists = (lock != BNULL);
+        UnLock(lock);
+        FreeVec(info);
+    }
+
+    return exists;
+}
+
+// Copy into this directory, respecting icons.
+// With WBCOPYF_MOVE, the source is deleted as it is copied.
+BOOL _wbCopyIntoCurrentAt(struct Library *DOSBase, struct Library *IconBase, BPTR src_dir, CONST_STRPTR src_file, LONG targetX, LONG targetY, struct wbProgress *progress)
 {
     ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
 
     BOOL ok = FALSE;
 
+    // Volumes are only ever copied.
+    BOOL move = wbCopyMove(progress) && src_dir != BNULL;
+
     BPTR pwd = CurrentDir(src_dir);
     BPTR src_lock = Lock(src_file, SHARED_LOCK);
     LONG err = IoErr();
     CurrentDir(pwd);
 
     if (src_lock != BNULL) {
-        // Copy the icon.
+        struct DiskObject *diskobject = NULL;
+        if (wbCopySync(progress) && wbIconExistsCurrent(DOSBase, src_file)) {
+            // Keep the icon (and its place) from the earlier copy.
+            ok = TRUE;
+        } else {
+            // Copy the icon.
+            BPTR pwd = CurrentDir(src_dir);
+            diskobject = GetDiskObject(src_file);
+            CurrentDir(pwd);
+            if (diskobject != NULL) {
+                // Set positioning information.
+                diskobject->do_CurrentX = targetX;
+                diskobject->do_CurrentY = targetY;
+                // Write out to the new location.
+                ok = PutDiskObject(src_file, diskobject);
+                err = IoErr();
+                FreeDiskObject(diskobject);
+            }
+        }
+        if (ok) {
+            STRPTR target = NULL;
+            if (move) {
+                // A soft link is moved as a link, rather than as a copy
+                // of what it points to.
+                BPTR pwd = CurrentDir(src_dir);
+                target = wbSoftLinkTargetCurrent(DOSBase, src_file);
+                CurrentDir(pwd);
+            }
+            if (target != NULL) {
+                UnLock(src_lock);
+                ok = wbMakeSoftLinkCurrent(DOSBase, src_file, target, wbCopySync(progress));
+                err = IoErr();
+                FreeVec(target);
+                if (ok && progress != NULL) {
+                    progress->wp_Files++;
+                }
+            } else {
+                ok = wbCopyLockCurrent(DOSBase, src_file, src_lock, move, progress);
+                err = IoErr();
+            }
+            if (!ok && diskobject != NULL && !move) {
+                // A failed move has already moved some of the contents,
+                // so it keeps the icon.
+                DeleteDiskObject((STRPTR)src_file);
+            }
+            if (ok && move) {
+                // Everything is copied. Now the source (which is empty,
+                // if it is a drawer) and its icon can go.
+                BPTR pwd = CurrentDir(src_dir);
+                ok = DeleteFile(src_file);
+                err = IoErr();
+                if (ok) {
+                    DeleteDiskObject((STRPTR)src_file);
+                }
+                CurrentDir(pwd);
+            }
+        } else {
+            UnLock(src_lock);
+        }
+    }
+
+    SetIoErr(err);
+
+    return ok;
+}
+
+// Move an icon into this directory, after its object has been moved.
+//
+// The '.info' file is simply renamed, then only its position is patched,
+// so the imagery is never decoded or re-encoded. If the rename fails, fall
+// back to writing a new icon and deleting the old one.
+static BOOL wbMoveIconCurrent(struct Library *DOSBase, struct Library *IconBase, BPTR src_dir, CONST_STRPTR src_file, CONST_STRPTR abspath, LONG targetX, LONG targetY)
+{
+    BOOL ok = FALSE;
+    LONG err;
+
+    LONG src_len = STRLEN(abspath) + 5 + 1;
+    LONG dst_len = STRLEN(src_file) + 5 + 1;
+    STRPTR src_info = AllocVec(src_len + dst_len, MEMF_ANY);
+    if (src_info == NULL) {
+        SetIoErr(ERROR_NO_FREE_STORE);
+        return FALSE;
+    }
+    STRPTR dst_info = &src_info[src_len];
+    snprintf(src_info, src_len, "%s.info", abspath);
+    snprintf(dst_info, dst_len, "%s.info", src_file);
+
+    ok = Rename(src_info, dst_info);
+    err = IoErr();
+    FreeVec(src_info);
+
+    if (!ok && err == ERROR_OBJECT_NOT_FOUND) {
+        // No icon to move.
+        SetIoErr(0);
+        return TRUE;
+    }
+
+    if (ok) {
+        // Only the header is needed to patch the position.
+        struct DiskObject *diskobject = GetIconTags(src_file,
+                ICONGETA_FailIfUnavailable, TRUE,
+                ICONGETA_RemapIcon, FALSE,
+                ICONGETA_GenerateImageMasks, FALSE,
+                TAG_END);
+        err = IoErr();
+        if (diskobject != NULL) {
+            if (diskobject->do_CurrentX != targetX || diskobject->do_CurrentY != targetY) {
+                diskobject->do_CurrentX = targetX;
+                diskobject->do_CurrentY = targetY;
+                ok = PutIconTags(src_file, diskobject, ICONPUTA_OnlyUpdatePosition, TRUE, TAG_END);
+                if (!ok) {
+                    // Some icon formats can't be patched in place.
+                    ok = PutDiskObject(src_file, diskobject);
+                }
+                err = IoErr();
+            }
+            FreeDiskObject(diskobject);
+        }
+    } else {
         BPTR pwd = CurrentDir(src_dir);
         struct DiskObject *diskobject = GetDiskObject(src_file);
         CurrentDir(pwd);
@@ -499,25 +2145,22 @@ BOOL _wbCopyIntoCurrentAt(struct Library *DOSBase, struct Library *IconBase, BPT
             ok = PutDiskObject(src_file, diskobject);
             err = IoErr();
             FreeDiskObject(diskobject);
-        }
-        if (ok) {
-            ok = wbCopyLockCurrent(DOSBase, src_file, src_lock);
-            err = IoErr();
-            if (!ok && diskobject != NULL) {
-                DeleteDiskObject((STRPTR)src_file);
+            if (ok) {
+                // Remove the old disk object.
+                BPTR pwd = CurrentDir(src_dir);
+                ok = DeleteDiskObject((STRPTR)src_file);
+                err = IoErr();
+                CurrentDir(pwd);
             }
-        } else {
-            UnLock(src_lock);
         }
     }
 
     SetIoErr(err);
-
     return ok;
 }
 
 // Move (rename) into this directory, respecting icons.
-BOOL _wbMoveIntoCurrentAt(struct Library *DOSBase, struct Library *IconBase, BPTR src_dir, CONST_STRPTR src_file, LONG targetX, LONG targetY)
+BOOL _wbMoveIntoCurrentAt(struct Library *DOSBase, struct Library *IconBase, BPTR src_dir, CONST_STRPTR src_file, LONG targetX, LONG targetY, struct wbProgress *progress)
 {
     ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
 
@@ -530,28 +2173,13 @@ BOOL _wbMoveIntoCurrentAt(struct Library *DOSBase, struct Library *IconBase, BPT
     if (abspath != NULL) {
         ok = Rename(abspath, src_file);
         err = IoErr();
+        if (ok && progress != NULL) {
+            progress->wp_Files++;
+        }
         if (ok) {
-            // Move the icon, also. We could just do a Rename() of it, but it's more 'Workbench safe'
-            // to do a GetDiskObject()/PutDiskObject()/DeleteDiskObject()
-            BPTR pwd = CurrentDir(src_dir);
-            struct DiskObject *diskobject = GetDiskObject(src_file);
-            CurrentDir(pwd);
-            if (diskobject != NULL) {
-                // Set positioning information.
-                diskobject->do_CurrentX = targetX;
-                diskobject->do_CurrentY = targetY;
-                // Write out to the new location.
-                ok = PutDiskObject(src_file, diskobject);
-                err = IoErr();
-                FreeDiskObject(diskobject);
-                if (ok) {
-                    // Remove the old disk object.
-                    BPTR pwd = CurrentDir(src_dir);
-                    ok = DeleteDiskObject((STRPTR)src_file);
-                    err = IoErr();
-                    CurrentDir(pwd);
-                }
-            }
+            // Move the icon, also.
+            ok = wbMoveIconCurrent(DOSBase, IconBase, src_dir, src_file, abspath, targetX, targetY);
+            err = IoErr();
         }
         FreeVec(abspath);
     }
@@ -561,9 +2189,70 @@ BOOL _wbMoveIntoCurrentAt(struct Library *DOSBase, struct Library *IconBase, BPT
     return ok;
 }
 
+// What a drop from one source drawer into CurrentDir() means.
+enum wbDropAction {
+    WBDROP_IGNORE,
+    WBDROP_MOVE,
+    WBDROP_COPY,
+};
+
+// Decide what to do with all the items dropped from one source drawer.
+static ULONG wbDropActionFor(struct Library *DOSBase, BPTR dst_lock, BOOL dst_is_root, BPTR src_lock)
+{
+    // Dropping to same directory? Ignore icon reposition for now.
+    if (SameLock(dst_lock, src_lock) == LOCK_SAME) {
+        // Ok, nothing to do here. (yet)
+        D(bug("%s: Window icon reposition into %s\n", __func__, sCURRDIR()));
+        return WBDROP_IGNORE;
+    }
+
+    // If both parent locks are BNULL, it's a diskcopy. (not yet supported!)
+    if (dst_lock == BNULL) {
+        // root window move - is this an icon move or a 'bad drop'?
+        D(if (src_lock == BNULL) bug("%s: Root icon position move\n", __func__));
+        D(if (src_lock != BNULL) bug("%s: Ignoring into-root-window move\n", __func__));
+        return WBDROP_IGNORE;
+    }
+
+    if (src_lock == BNULL && dst_is_root) {
+        D(bug("%s: Ignoring DiskCopy\n", __func__));
+        return WBDROP_IGNORE;
+    }
+
+    // If parent is on same device, it's a move. Otherwise it's a copy.
+    return SameDevice(dst_lock, src_lock) ? WBDROP_MOVE : WBDROP_COPY;
+}
+
+// Find the entry of 'dir' that is 'lock', or one of its parents.
+// Dropping that entry into 'lock' would be recursive.
+static BOOL wbDropRecursiveName(struct Library *DOSBase, BPTR dir, BPTR lock, struct FileInfoBlock *fib)
+{
+    BOOL found = FALSE;
+    BPTR cur = DupLock(lock);
+
+    while (cur != BNULL && !found) {
+        BPTR parent = ParentDir(cur);
+        if (parent != BNULL && SameLock(parent, dir) == LOCK_SAME) {
+            found = Examine(cur, fib);
+        }
+        UnLock(cur);
+        cur = parent;
+    }
+    UnLock(cur);
+
+    return found;
+}
+
 // Drop all items into CurrentDir()
+//
+// Items are handled in batches, one per WBOPENA_ArgLock. What to do with a
+// batch, and which of its items (if any) would be a recursive move, is worked
+// out once per batch. A failed item doesn't stop the rest of the drop; if
+// 'errors' is not NULL, it gets the IoErr() of each WBOPENA_ArgName, in order,
+// or 0 if that item was fine.
+//
 // NOTE: CurrentDir(my->ParentLock) must already be set before calling!
-BOOL _wbDropOntoCurrentAt(struct Library *DOSBase, struct Library *IconBase, struct Library *UtilityBase, struct TagItem *args, LONG targetX, LONG targetY)
+BOOL _wbDropOntoCurrentAt(struct Library *DOSBase, struct Library *IconBase, struct Library *UtilityBase, struct TagItem *args, LONG targetX, LONG targetY, LONG *errors, struct wbProgress *progress)
 {
     ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
 
@@ -573,98 +2262,202 @@ BOOL _wbDropOntoCurrentAt(struct Library *DOSBase, struct Library *IconBase, str
     BPTR dst_lock = CurrentDir(BNULL);
     CurrentDir(dst_lock);
 
+    struct FileInfoBlock *fib = AllocDosObjectTags(DOS_FIB, TAG_END);
+    if (fib == NULL) {
+        SetIoErr(ERROR_NO_FREE_STORE);
+        return FALSE;
+    }
+
+    BOOL dst_is_root = FALSE;
+    if (dst_lock != BNULL) {
+        BPTR dst_parent = ParentDir(dst_lock);
+        dst_is_root = (dst_parent == BNULL);
+        UnLock(dst_parent);
+    }
+
     BPTR src_lock = BNULL;
     CONST_STRPTR src_file;
+    ULONG action = WBDROP_IGNORE;
+    CONST_STRPTR recursive = NULL;
+    BOOL cancelled = FALSE;
     BOOL ok = TRUE;
     LONG err = 0;
+    ULONG index = 0;
 
     while ((ti = NextTagItem(&args)) != NULL) {
         switch (ti->ti_Tag) {
         case WBOPENA_ArgLock:
+            // A new batch.
             src_lock = (BPTR)ti->ti_Data;
+            action = wbDropActionFor(DOSBase, dst_lock, dst_is_root, src_lock);
+            recursive = NULL;
+            if (action != WBDROP_IGNORE && src_lock != BNULL && wbDropRecursiveName(DOSBase, src_lock, dst_lock, fib)) {
+                recursive = fib->fib_FileName;
+            }
             break;
         case WBOPENA_ArgName:
             src_file = (CONST_STRPTR)ti->ti_Data;
 
-            // Dropping to same directory? Ignore icon reposition for now.
-            if (SameLock(dst_lock, src_lock) == LOCK_SAME) {
-                // Ok, nothing to do here. (yet)
-                D(bug("%s: Window icon reposition of %s to %ld,%ld\n", __func__, src_file, (IPTR)targetX, (IPTR)targetY));
-                ok = TRUE;
-                break;
-            }
-
-            // Is the lock for the source the same as current? Don't do that, it'd be recusive!
-            CurrentDir(src_lock);
-            BPTR this_lock = Lock(src_file, SHARED_LOCK);
-            err = IoErr();
-            CurrentDir(dst_lock);
-            if (this_lock == BNULL) {
-                ok = FALSE;
-                D(bug("%s: Unable to lock source file %s\n", __func__, src_file));
-                break;
-            }
-
-            BOOL same = (SameLock(dst_lock, this_lock) == LOCK_SAME);
-            UnLock(this_lock);
-            if (same) {
-                // Ok, nothing to do here. (ever)
-                D(bug("%s: Ignoring recusive directory move of %s\n", __func__, src_file));
-                break;
-            }
-
-            // If both parent locks are BNULL, it's a diskcopy. (not yet supported!)
-            if (dst_lock == BNULL) {
-                // root window move - is this an icon move or a 'bad drop'?
+            LONG item_err = 0;
+            if (cancelled || wbProgressCancelled(DOSBase, progress)) {
+                cancelled = TRUE;
+                item_err = ERROR_BREAK;
+            } else if (action != WBDROP_IGNORE) {
+                BOOL is_recursive;
                 if (src_lock == BNULL) {
-                    D(bug("%s: Root icon position move of %s to (%ld,%ld)\n", __func__, src_file, (IPTR)targetX, (IPTR)targetY));
-                    ok = TRUE;
-                    break;
+                    // A volume - check it the hard way.
+                    CurrentDir(BNULL);
+                    BPTR this_lock = Lock(src_file, SHARED_LOCK);
+                    CurrentDir(dst_lock);
+                    is_recursive = (this_lock != BNULL && SameLock(dst_lock, this_lock) == LOCK_SAME);
+                    UnLock(this_lock);
                 } else {
-                    D(bug("%s: Ignoring into-root-window move of %s\n", __func__, src_file));
-                    break;
+                    is_recursive = (recursive != NULL && wbNameSame(recursive, src_file));
                 }
-            } else {
-                BPTR dst_parent = ParentDir(dst_lock);
-                BOOL is_diskcopy = (src_lock == BNULL && dst_parent == BNULL);
-                UnLock(dst_parent);
-                if (is_diskcopy) {
-                    D(bug("%s: Ignoring DiskCopy of %s\n", __func__, src_file));
-                    break;
+
+                if (is_recursive) {
+                    // Ok, nothing to do here. (ever)
+                    D(bug("%s: Ignoring recusive directory move of %s\n", __func__, src_file));
+                } else if (action == WBDROP_MOVE) {
+                    D(bug("%s: Move %s into %s at (%ld,%ld)\n", __func__, src_file, sCURRDIR(), (IPTR)targetX, (IPTR)targetY));
+                    if (!_wbMoveIntoCurrentAt(DOSBase, IconBase, src_lock, src_file, targetX, targetY, progress)) {
+                        item_err = IoErr();
+                    }
+                } else {
+                    D(bug("%s: Copy %s into %s at (%ld,%ld)\n", __func__, src_file, sCURRDIR(), (IPTR)targetX, (IPTR)targetY));
+                    if (!_wbCopyIntoCurrentAt(DOSBase, IconBase, src_lock, src_file, targetX, targetY, progress)) {
+                        item_err = IoErr();
+                    }
                 }
             }
 
-            // If parent is on same device, it's a move. Otherwise it's a copy.
-            if (SameDevice(dst_lock, src_lock)) {
-                D(bug("%s: Move %s into %s at (%ld,%ld)\n", __func__, src_file, sCURRDIR(), (IPTR)targetX, (IPTR)targetY));
-                ok = _wbMoveIntoCurrentAt(DOSBase, IconBase, src_lock, src_file, targetX, targetY);
-                err = IoErr();
-            } else {
-                D(bug("%s: Copy %s into %s at (%ld,%ld)\n", __func__, src_file, sCURRDIR(), (IPTR)targetX, (IPTR)targetY));
-                ok = _wbCopyIntoCurrentAt(DOSBase, IconBase, src_lock, src_file, targetX, targetY);
-                err = IoErr();
+            if (errors != NULL) {
+                errors[index] = item_err;
+            }
+            index++;
+
+            // Report the first failure.
+            if (item_err != 0 && ok) {
+                err = item_err;
+                ok = FALSE;
             }
             break;
         default:
             break;
         }
-
-        if (!ok) {
-            break;
-        }
     }
 
+    FreeDosObject(DOS_FIB, fib);
+
     SetIoErr(err);
 
     return ok;
 }
 
-// Load .backdrop file into a list of locks.
-void _wbBackdropLoadCurrent(struct Library *DOSBase, struct List *backdrops)
+ULONG wbBackdropHash(ULONG hash, CONST_STRPTR path)
+{
+    for (; *path != 0; path++) {
+        hash = hash * 31 + wbNameFold(*path);
+    }
+
+    return hash;
+}
+
+ULONG wbBackdropHashDir(CONST_STRPTR path)
+{
+    // Only the volume relative part is in .backdrop.
+    CONST_STRPTR cp = strchr(path, ':');
+    if (cp == NULL) {
+        cp = path;
+    }
+
+    ULONG hash = wbBackdropHash(0, cp);
+    size_t len = STRLEN(cp);
+    if (len > 0 && cp[len-1] != ':' && cp[len-1] != '/') {
+        hash = wbBackdropHash(hash, "/");
+    }
+
+    return hash;
+}
+
+ULONG wbBackdropHashParent(CONST_STRPTR path)
+{
+    CONST_STRPTR file = path;
+    ULONG hash = 0;
+
+    for (CONST_STRPTR cp = path; *cp != 0; cp++) {
+        if (*cp == '/' || *cp == ':') {
+            file = cp + 1;
+        }
+    }
+
+    // The drawer's part of the path, with its '/' or ':'.
+    for (; path < file; path++) {
+        hash = hash * 31 + wbNameFold(*path);
+    }
+
+    return hash;
+}
+
+static inline struct MinList *wbBackdropBucket(struct wbBackdropList *backdrops, ULONG key)
+{
+    return &backdrops->wbb_Index[key % WBBACKDROP_INDEX];
+}
+
+// Add an entry for a lock, which is then owned by the entry.
+// With no lock, the entry is pending until wbBackdropResolveCurrent().
+// Either way, it is indexed by its path from the start.
+static struct wbBackdropEntry *wbBackdropEntryAdd(struct wbBackdropList *backdrops, CONST_STRPTR path, BPTR lock)
+{
+    LONG len = STRLEN(path) + 1;
+    struct wbBackdropEntry *wbe = AllocVec(sizeof(*wbe) + len, MEMF_ANY);
+    if (wbe == NULL) {
+        return NULL;
+    }
+
+    wbe->wbe_Lock = lock;
+    wbe->wbe_Key = wbBackdropHash(0, path);
+    wbe->wbe_Path = (STRPTR)&wbe[1];
+    CopyMem(path, wbe->wbe_Path, len);
+    AddTailMinList(&backdrops->wbb_Entries, &wbe->wbe_Node);
+    AddTailMinList(wbBackdropBucket(backdrops, wbe->wbe_Key), &wbe->wbe_Hash);
+    if (lock == BNULL) {
+        AddTailMinList(&backdrops->wbb_Pending, &wbe->wbe_Pending);
+    }
+
+    return wbe;
+}
+
+static void wbBackdropEntryFree(struct Library *DOSBase, struct wbBackdropEntry *wbe)
+{
+    RemoveMinNode(&wbe->wbe_Node);
+    RemoveMinNode(&wbe->wbe_Hash);
+    if (wbe->wbe_Lock == BNULL) {
+        RemoveMinNode(&wbe->wbe_Pending);
+    }
+    UnLock(wbe->wbe_Lock);
+    FreeVec(wbe);
+}
+
+void wbBackdropInit(struct wbBackdropList *backdrops)
+{
+    NEWLIST(&backdrops->wbb_Entries);
+    NEWLIST(&backdrops->wbb_Pending);
+    for (int i = 0; i < WBBACKDROP_INDEX; i++) {
+        NEWLIST(&backdrops->wbb_Index[i]);
+    }
+}
+
+// Load .backdrop file into a list of paths.
+//
+// Nothing is locked here: this runs as each volume icon is created, and a
+// large or stale .backdrop shouldn't hold up the root window. Entries are
+// locked by wbBackdropResolveCurrent() later, in the background.
+void _wbBackdropLoadCurrent(struct Library *DOSBase, struct wbBackdropList *backdrops)
 {
     ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
 
-    NEWLIST(backdrops);
+    wbBackdropInit(backdrops);
 
     STRPTR buff = AllocVec(PATH_MAX, MEMF_ANY);
     if (!buff) {
@@ -672,6 +2465,14 @@ void _wbBackdropLoadCurrent(struct Library *DOSBase, struct List *backdrops)
     }
 
     BPTR fh = Open(".backdrop", MODE_OLDFILE);
+    if (fh == BNULL && IoErr() == ERROR_OBJECT_NOT_FOUND) {
+        // A save stopped after putting the old file aside, and before
+        // renaming the new one into place. The new one was complete.
+        fh = Open(".backdrop.new", MODE_OLDFILE);
+        if (fh == BNULL) {
+            fh = Open(".backdrop.old", MODE_OLDFILE);
+        }
+    }
     D(if (fh == BNULL) bug("%s: No .backdrop on volume\n", sCURRDIR()); );
     if (fh != BNULL) {
         while (FGets(fh, buff, PATH_MAX) != NULL) {
@@ -685,18 +2486,8 @@ void _wbBackdropLoadCurrent(struct Library *DOSBase, struct List *backdrops)
                 continue;
             }
             D(bug("%s.backdrop: '%s'\n", sCURRDIR(), buff));
-            struct Node *node = AllocVec(sizeof(*node), MEMF_ANY | MEMF_CLEAR);
-            D(if (node == NULL) bug("%s.backdrop:  OOM?\n", sCURRDIR()));
-            if (node != NULL) {
-                BPTR backdrop_lock = Lock(buff, SHARED_LOCK);
-                if (backdrop_lock != BNULL) {
-                    D(bug("%s: %s.backdrop: %s\n",__func__, sCURRDIR(), sLOCKNAME(backdrop_lock)));
-                    node->ln_Name = (APTR)backdrop_lock;
-                    AddTail(backdrops, node);
-                } else {
-                    D(bug("%s: %s.backdrop: %s - %ld\n",__func__, sCURRDIR(), buff, IoErr()));
-                    FreeVec(node);
-                }
+            if (wbBackdropEntryAdd(backdrops, buff, BNULL) == NULL) {
+                D(bug("%s.backdrop:  OOM?\n", sCURRDIR()));
             }
         }
         Close(fh);
@@ -705,133 +2496,205 @@ void _wbBackdropLoadCurrent(struct Library *DOSBase, struct List *backdrops)
     FreeVec(buff);
 }
 
-void wbBackdropFree(struct List *backdrops)
+void _wbBackdropFree(struct Library *DOSBase, struct wbBackdropList *backdrops)
 {
-    struct Node *node;
-    while ((node = RemHead(backdrops)) != NULL) {
-        UnLock((BPTR)node->ln_Name);
-        FreeVec(node);
+    struct wbBackdropEntry *wbe;
+    while ((wbe = wbBackdropNext(backdrops, NULL)) != NULL) {
+        wbBackdropEntryFree(DOSBase, wbe);
     }
 }
 
 // Save .backdrop file into a list of locks.
-BOOL _wbBackdropSaveCurrent(struct Library *DOSBase, struct List *backdrops)
+//
+// The new file is written under a temporary name, and only replaces the
+// old one once it is complete. The old one is put aside, not deleted,
+// until the new one is in place; see wbBackdropLoadCurrent() for what
+// is read if that is interrupted.
+BOOL _wbBackdropSaveCurrent(struct Library *DOSBase, struct wbBackdropList *backdrops)
 {
     BOOL ok = FALSE;
-    BPTR fh = Open(".backdrop", MODE_NEWFILE);
-    D(bug("%s: Open %s.backdrop\n", __func__, sCURRDIR()));
-    D(if (fh == BNULL) bug("%s: Can't open .backdrop on '%s': %ld\n", __func__, sCURRDIR(), IoErr()); );
+    BPTR fh = Open(".backdrop.new", MODE_NEWFILE);
+    D(bug("%s: Open %s.backdrop.new\n", __func__, sCURRDIR()));
+    D(if (fh == BNULL) bug("%s: Can't open .backdrop.new on '%s': %ld\n", __func__, sCURRDIR(), IoErr()); );
     if (fh != BNULL) {
-        struct Node *node;
-
-        ForeachNode(backdrops, node) {
-            D(bug("%s: %s.backdrop lock %lx\n", __func__, sCURRDIR(), (IPTR)node->ln_Name));
-            STRPTR path = wbAbspathLock((BPTR)node->ln_Name);
-            if (path) {
-                D(bug("%s: %s.backdrop %s\n", __func__, sCURRDIR(), path));
-                // Find leading volume name
-                char *cp = strchr(path, ':');
-                if (cp) {
-                    D(bug("%s: %s.backdrop: << %s\n", __func__, sCURRDIR(), cp));
-                    FPuts(fh, cp);
-                    FPuts(fh, "\n");
-                }
+        struct wbBackdropEntry *wbe = NULL;
+        LONG err = 0;
 
-                FreeVec(path);
+        // The paths were kept when the entries were made, so no NameFromLock() here.
+        while (err == 0 && (wbe = wbBackdropNext(backdrops, wbe)) != NULL) {
+            D(bug("%s: %s.backdrop: << %s\n", __func__, sCURRDIR(), wbe->wbe_Path));
+            if (FPuts(fh, wbe->wbe_Path) != 0 || FPuts(fh, "\n") != 0) {
+                err = IoErr();
             }
+        }
 
+        D(bug("%s: Close %s.backdrop.new\n", __func__, sCURRDIR()));
+        if (!Close(fh) && err == 0) {
+            err = IoErr();
         }
 
-        D(bug("%s: Close %s.backdrop\n", __func__, sCURRDIR()));
-        Close(fh);
-        ok = TRUE;
+        if (err == 0) {
+            // Rename() won't replace an existing file.
+            DeleteFile(".backdrop.old");
+            BOOL aside = Rename(".backdrop", ".backdrop.old");
+            ok = Rename(".backdrop.new", ".backdrop");
+            if (ok) {
+                DeleteFile(".backdrop.old");
+            } else {
+                err = IoErr();
+                D(bug("%s: Can't rename .backdrop.new on '%s': %ld\n", __func__, sCURRDIR(), (IPTR)err));
+                if (aside) {
+                    Rename(".backdrop.old", ".backdrop");
+                }
+                SetIoErr(err);
+            }
+        } else {
+            D(bug("%s: Can't write .backdrop.new on '%s': %ld\n", __func__, sCURRDIR(), (IPTR)err));
+            DeleteFile(".backdrop.new");
+            SetIoErr(err);
+        }
     }
 
     return ok;
 }
 
-BOOL _wbBackdropContains(struct Library *DOSBase, struct List *backdrops, BPTR lock)
+struct wbBackdropEntry *wbBackdropPending(struct wbBackdropList *backdrops)
 {
-    struct Node *node;
-    BOOL found = FALSE;
-    ForeachNode(backdrops, node) {
-        if (SameLock((BPTR)node->ln_Name, lock) == LOCK_SAME) {
-            found = TRUE;
-            break;
-        }
-    }
+    struct MinNode *node = backdrops->wbb_Pending.mlh_Head;
 
-    return found;
+    return (node->mln_Succ != NULL) ? wbBackdropFromPending(node) : NULL;
 }
 
-BOOL _wbBackdropAdd(struct Library *DOSBase, struct List *backdrops, BPTR lock)
+struct wbBackdropEntry *_wbBackdropResolveCurrent(struct Library *DOSBase, struct wbBackdropList *backdrops, struct wbBackdropEntry *wbe)
 {
-    if (wbBackdropContains(backdrops, lock)) {
-        D(bug("%s: Backdrop already has %s in it!\n", __func__, sLOCKNAME(lock)));
-        return TRUE;
+    if (wbe->wbe_Lock != BNULL) {
+        return wbe;
     }
 
-    BOOL added = FALSE;
-    struct Node *node = AllocVec(sizeof(struct Node), MEMF_ANY | MEMF_CLEAR);
-    if (node) {
-        BPTR duplock = DupLock(lock);
-        D(bug("%s: Adding DupLock(%lx) => %lx\n", __func__, lock, duplock));
-        if (duplock != BNULL) {
-            node->ln_Name = (APTR)duplock;
-            AddTail(backdrops, node);
-            added = TRUE;
+    BPTR lock = Lock(wbe->wbe_Path, SHARED_LOCK);
+    if (lock == BNULL) {
+        LONG err = IoErr();
+        if (wbBackdropStale(err)) {
+            D(bug("%s: %s.backdrop: %s - %ld, dropped\n",__func__, sCURRDIR(), wbe->wbe_Path, (IPTR)err));
+            wbBackdropEntryFree(DOSBase, wbe);
         } else {
-            FreeVec(node);
+            // In use, out of memory, volume busy... Keep it, and try again later.
+            D(bug("%s: %s.backdrop: %s - %ld, kept\n",__func__, sCURRDIR(), wbe->wbe_Path, (IPTR)err));
+            RemoveMinNode(&wbe->wbe_Pending);
+            AddTailMinList(&backdrops->wbb_Pending, &wbe->wbe_Pending);
         }
+        SetIoErr(err);
+        return NULL;
     }
 
-    return added;
+    D(bug("%s: %s.backdrop: %s\n",__func__, sCURRDIR(), sLOCKNAME(lock)));
+    wbe->wbe_Lock = lock;
+    RemoveMinNode(&wbe->wbe_Pending);
+
+    return wbe;
 }
 
-BOOL _wbBackdropDel(struct Library *DOSBase, struct List *backdrops, BPTR lock)
+BOOL _wbBackdropResolveKeyCurrent(struct Library *DOSBase, struct wbBackdropList *backdrops, ULONG key)
 {
-    struct Node *node;
-    BOOL removed = FALSE;
-    ForeachNode(backdrops, node) {
-        if (SameLock((BPTR)node->ln_Name, lock) == LOCK_SAME) {
-            Remove(node);
-            UnLock((BPTR)node->ln_Name);
-            FreeVec(node);
-            removed = TRUE;
-            break;
+    BOOL stale = FALSE;
+    struct MinNode *node, *next;
+
+    // A stale entry is deleted from the bucket as it is resolved.
+    ForeachNodeSafe(wbBackdropBucket(backdrops, key), node, next) {
+        struct wbBackdropEntry *wbe = wbBackdropFromHash(node);
+        if (wbe->wbe_Key == key && wbe->wbe_Lock == BNULL) {
+            if (wbBackdropResolveCurrent(backdrops, wbe) == NULL && wbBackdropStale(IoErr())) {
+                stale = TRUE;
+            }
         }
     }
 
-    return removed;
+    return stale;
 }
 
-BOOL _wbBackdropNext(struct Library *DOSBase, struct List *backdrops, BPTR lock, BPTR *next_ptr)
+// Find the resolved entry for a lock, whose path has 'key'.
+static struct wbBackdropEntry *wbBackdropFind(struct Library *DOSBase, struct wbBackdropList *backdrops, ULONG key, BPTR lock)
 {
-    struct Node *node;
-    BPTR next = BNULL;
+    struct MinNode *node;
 
-    BOOL present = FALSE;
-    BOOL valid = FALSE;
-    ForeachNode(backdrops, node) {
-        if (next == lock) {
-            // This also catches the 'lock == BNULL' first case.
-            next = (BPTR)node->ln_Name;
-            valid = TRUE;
-            break;
+    ForeachNode(wbBackdropBucket(backdrops, key), node) {
+        struct wbBackdropEntry *wbe = wbBackdropFromHash(node);
+        if (wbe->wbe_Key == key && wbe->wbe_Lock != BNULL && SameLock(wbe->wbe_Lock, lock) == LOCK_SAME) {
+            return wbe;
         }
-        if (lock == (BPTR)node->ln_Name) {
-            // Mark that the next lock should be returned.
-            next = lock;
-            present = TRUE;
+    }
+
+    return NULL;
+}
+
+BOOL _wbBackdropContains(struct Library *DOSBase, struct wbBackdropList *backdrops, ULONG key, BPTR lock)
+{
+    return wbBackdropFind(DOSBase, backdrops, key, lock) != NULL;
+}
+
+BOOL _wbBackdropAdd(struct Library *DOSBase, struct wbBackdropList *backdrops, BPTR lock)
+{
+    STRPTR path = wbAbspathLock(lock);
+    if (path == NULL) {
+        return FALSE;
+    }
+
+    // Keep the volume relative part.
+    CONST_STRPTR cp = strchr(path, ':');
+    if (cp == NULL) {
+        FreeVec(path);
+        return FALSE;
+    }
+
+    // The same path is the same entry, resolved or not.
+    ULONG key = wbBackdropHash(0, cp);
+    struct MinNode *node;
+    ForeachNode(wbBackdropBucket(backdrops, key), node) {
+        struct wbBackdropEntry *wbe = wbBackdropFromHash(node);
+        if (wbe->wbe_Key == key && wbNameSame(wbe->wbe_Path, cp)) {
+            D(bug("%s: Backdrop already has %s in it!\n", __func__, path));
+            FreeVec(path);
+            if (wbe->wbe_Lock == BNULL) {
+                // Still pending - it's resolved by this lock.
+                wbe->wbe_Lock = DupLock(lock);
+                if (wbe->wbe_Lock == BNULL) {
+                    return FALSE;
+                }
+                RemoveMinNode(&wbe->wbe_Pending);
+            }
+            return TRUE;
         }
     }
 
-    if (!valid) {
-        next = BNULL;
+    BOOL added = FALSE;
+    BPTR duplock = DupLock(lock);
+    D(bug("%s: Adding DupLock(%lx) => %lx\n", __func__, lock, duplock));
+    if (duplock != BNULL) {
+        added = (wbBackdropEntryAdd(backdrops, cp, duplock) != NULL);
+    }
+    if (!added) {
+        UnLock(duplock);
+    }
+    FreeVec(path);
+
+    return added;
+}
+
+BOOL _wbBackdropDel(struct Library *DOSBase, struct wbBackdropList *backdrops, ULONG key, BPTR lock)
+{
+    struct wbBackdropEntry *wbe = wbBackdropFind(DOSBase, backdrops, key, lock);
+    if (wbe == NULL) {
+        return FALSE;
     }
 
-    D(bug("%s: lock=%lx, next=%lx\n", __func__, (IPTR)lock, (IPTR)next));
-    *next_ptr = next;
+    wbBackdropEntryFree(DOSBase, wbe);
+
+    return TRUE;
+}
+
+struct wbBackdropEntry *wbBackdropNext(struct wbBackdropList *backdrops, struct wbBackdropEntry *wbe)
+{
+    struct MinNode *node = (wbe == NULL) ? backdrops->wbb_Entries.mlh_Head : wbe->wbe_Node.mln_Succ;
 
-    return present;
+    return (node->mln_Succ != NULL) ? wbBackdropFromNode(node) : NULL;
 }
@@ -18,6 +18,9 @@
 
 #include <proto/exec.h>
 #include <proto/dos.h>
+#include <exec/semaphores.h>
+#include <dos/exall.h>
+#include <stddef.h>
 
 #ifdef __AROS__
 #include "workbook_aros.h"
@@ -38,36 +41,167 @@ STRPTR _wbAbspathLock(struct Library *_DOSBase, BPTR lock);
 STRPTR _wbAbspathCurrent(struct Library *_DOSBase, CONST_STRPTR file);
 #define wbAbspathCurrent(file) _wbAbspathCurrent(DOSBase, file);
 
+// Progress of a file operation, shared between the operation and its owner.
+// The operation updates the counters as it goes; the owner may set
+// wp_Cancel at any time to stop the operation with ERROR_BREAK.
+// The owner sets wp_Flags before the operation starts.
+// All of the functions below accept a NULL progress.
+struct wbProgress {
+    volatile BOOL  wp_Cancel;
+    volatile ULONG wp_Files;    // Files (and directories) completed.
+    volatile ULONG wp_Bytes;    // Bytes copied.
+    ULONG          wp_Flags;    // WBCOPYF_*
+    volatile ULONG wp_Verified;   // Files read back with the right checksum.
+    volatile ULONG wp_Mismatched; // Files read back with the wrong checksum, and deleted.
+};
+
+#define WBCOPYF_SYNC    (1 << 0)    // Copy only new or changed files over an existing copy.
+#define WBCOPYF_VERIFY  (1 << 1)    // Read back each copied file, and compare its CRC-32 with the source's.
+#define WBCOPYF_MOVE    (1 << 2)    // Drops between devices delete each source entry once it is copied.
+
+// IoErr() of a copy that did not verify. DOS has no better code for it.
+#define WBERROR_VERIFY  ERROR_SEEK_ERROR
+
+// CRC-32 (as used by zip and Ethernet) of 'len' bytes, continuing from 'crc'.
+// Start with a 'crc' of 0.
+ULONG wbCrc32(ULONG crc, const void *buff, ULONG len);
+
+// Tree walk callback, called with CurrentDir() set to the directory holding 'ead'.
+// 'ead' has everything up to ED_DATE filled in. A callback may change CurrentDir(),
+// but must restore it before returning.
+typedef LONG (*wbWalkFunc)(struct Library *_DOSBase, struct ExAllData *ead, APTR arg);
+
+#define WBWALK_STOP     0   // Stop the walk. IoErr() has the reason.
+#define WBWALK_CONTINUE 1   // Keep going, descending into directories.
+#define WBWALK_SKIP     2   // Don't descend into this directory.
+
+// Walk the contents of a directory (not the directory itself).
+// Every entry is passed to 'pre' before a directory's contents are visited,
+// and directories are passed to 'post' once their contents are done. At that
+// point the directory is no longer locked by the walk, so 'post' may delete it.
+// Soft links and hard linked directories are visited, but never descended into.
+// Either callback may be NULL. Deep trees do not use the process stack.
+BOOL _wbWalkLock(struct Library *_DOSBase, BPTR dir, wbWalkFunc pre, wbWalkFunc post, APTR arg, struct wbProgress *progress);
+#define wbWalkLock(dir, pre, post, arg, progress) _wbWalkLock(DOSBase, dir, pre, post, arg, progress)
+
+// Total size of the contents of a directory.
+struct wbSize {
+    ULONG ws_Files;     // Files and directories.
+    ULONG ws_Bytes;
+    ULONG ws_Blocks;    // Data blocks, estimated from 'ws_BlockSize', plus one header block per entry.
+    ULONG ws_BlockSize; // Set by the caller.
+};
+
+BOOL _wbSizeLock(struct Library *_DOSBase, BPTR dir, struct wbSize *size, struct wbProgress *progress);
+#define wbSizeLock(dir, size, progress) _wbSizeLock(DOSBase, dir, size, progress)
+
 // The following functions assume CurrentDir() is the target directory, and handle
 // a '.icon' file correctly.
-BOOL _wbDeleteFromCurrent(struct Library *_DOSBase, struct Library *_IconBase, CONST_STRPTR file, BOOL only_contents);
-#define wbDeleteFromCurrent(file, only_contents) _wbDeleteFromCurrent(DOSBase, IconBase, file, only_contents)
+BOOL _wbDeleteFromCurrent(struct Library *_DOSBase, struct Library *_IconBase, CONST_STRPTR file, BOOL only_contents, struct wbProgress *progress);
+#define wbDeleteFromCurrent(file, only_contents, progress) _wbDeleteFromCurrent(DOSBase, IconBase, file, only_contents, progress)
+
+// Existing 'Copy_N_of_...' names in a directory, so that making many copies
+// in one operation only scans the directory once. Pass the same cache to each
+// wbCopyBumpCurrent() of the operation, then wbBumpCacheFree() it.
+// Several processes may share a cache: each name is picked and noted
+// under wbc_Lock, so no two of them pick the same one.
+struct wbBumpCache {
+    struct SignalSemaphore wbc_Lock;
+    BPTR           wbc_Dir;     // Directory the names are from, or BNULL.
+    struct MinList wbc_Names;
+};
 
-BOOL _wbCopyBumpCurrent(struct Library *_DOSBase, struct Library *_IconBase, CONST_STRPTR src_file);
-#define wbCopyBumpCurrent(src_file) _wbCopyBumpCurrent(DOSBase, IconBase, src_file)
+void wbBumpCacheInit(struct wbBumpCache *cache);
+void _wbBumpCacheFree(struct Library *_DOSBase, struct wbBumpCache *cache);
+#define wbBumpCacheFree(cache) _wbBumpCacheFree(DOSBase, cache)
 
-BOOL _wbCopyIntoCurrentAt(struct Library *_DOSBase, struct Library *_IconBase, BPTR src_dir, CONST_STRPTR src_file, LONG targetX, LONG targetY);
-#define wbCopyIntoCurrentAt(src_dir, src_file, targetX, targetY) _wbCopyIntoCurrentAt(DOSBase, IconBase, src_dir, src_file, targetX, targetY)
-#define wbCopyIntoCurrent(src_dir, src_file) _wbCopyIntoCurrentAt(DOSBase, IconBase, src_dir, src_file, (LONG)NO_ICON_POSITION, (LONG)NO_ICON_POSITION)
-BOOL _wbMoveIntoCurrentAt(struct Library *_DOSBase, struct Library *_IconBase, BPTR src_dir, CONST_STRPTR src_file, LONG targetX, LONG targetY);
-#define wbMoveIntoCurrentAt(src_dir, src_file, targetX, targetY) _wbMoveIntoCurrentAt(DOSBase, IconBase, src_dir, src_file, targetX, targetY)
-#define wbMoveIntoCurrent(src_dir, src_file) _wbMoveIntoCurrentAt(DOSBase, IconBase, src_dir, src_file, (LONG)NO_ICON_POSITION, (LONG)NO_ICON_POSITION)
+// 'cache' may be NULL, for a single copy.
+BOOL _wbCopyBumpCurrent(struct Library *_DOSBase, struct Library *_IconBase, CONST_STRPTR src_file, struct wbBumpCache *cache, struct wbProgress *progress);
+#define wbCopyBumpCurrent(src_file, cache, progress) _wbCopyBumpCurrent(DOSBase, IconBase, src_file, cache, progress)
 
-BOOL _wbDropOntoCurrentAt(struct Library *_DOSBase, struct Library *_IconBase, struct Library *_UtilityBase, struct TagItem *tags, LONG targetX, LONG targetY);
-#define wbDropOntoCurrentAt(tags, targetX, targetY) _wbDropOntoCurrentAt(DOSBase, IconBase, UtilityBase, tags, targetX, targetY)
-#define wbDropOntoCurrent(tags) _wbDropOntoCurrentAt(DOSBase, IconBase, UtilityBase, tags, (LONG)NO_ICON_POSITION, (LONG)NO_ICON_POSITION)
+BOOL _wbCopyIntoCurrentAt(struct Library *_DOSBase, struct Library *_IconBase, BPTR src_dir, CONST_STRPTR src_file, LONG targetX, LONG targetY, struct wbProgress *progress);
+#define wbCopyIntoCurrentAt(src_dir, src_file, targetX, targetY, progress) _wbCopyIntoCurrentAt(DOSBase, IconBase, src_dir, src_file, targetX, targetY, progress)
+#define wbCopyIntoCurrent(src_dir, src_file, progress) _wbCopyIntoCurrentAt(DOSBase, IconBase, src_dir, src_file, (LONG)NO_ICON_POSITION, (LONG)NO_ICON_POSITION, progress)
+BOOL _wbMoveIntoCurrentAt(struct Library *_DOSBase, struct Library *_IconBase, BPTR src_dir, CONST_STRPTR src_file, LONG targetX, LONG targetY, struct wbProgress *progress);
+#define wbMoveIntoCurrentAt(src_dir, src_file, targetX, targetY, progress) _wbMoveIntoCurrentAt(DOSBase, IconBase, src_dir, src_file, targetX, targetY, progress)
+#define wbMoveIntoCurrent(src_dir, src_file, progress) _wbMoveIntoCurrentAt(DOSBase, IconBase, src_dir, src_file, (LONG)NO_ICON_POSITION, (LONG)NO_ICON_POSITION, progress)
 
-void _wbBackdropLoadCurrent(struct Library *_DOSBase, struct List *backdrops);
+// Drop WBOPENA_* tags into here. 'errors', if not NULL, has one entry per WBOPENA_ArgName,
+// and is set to the IoErr() of each item (0 for success). A failed item doesn't stop the drop.
+BOOL _wbDropOntoCurrentAt(struct Library *_DOSBase, struct Library *_IconBase, struct Library *_UtilityBase, struct TagItem *tags, LONG targetX, LONG targetY, LONG *errors, struct wbProgress *progress);
+#define wbDropOntoCurrentAt(tags, targetX, targetY, errors, progress) _wbDropOntoCurrentAt(DOSBase, IconBase, UtilityBase, tags, targetX, targetY, errors, progress)
+#define wbDropOntoCurrent(tags, errors, progress) _wbDropOntoCurrentAt(DOSBase, IconBase, UtilityBase, tags, (LONG)NO_ICON_POSITION, (LONG)NO_ICON_POSITION, errors, progress)
+
+// A .backdrop entry. Its volume relative path is kept, so that saving
+// .backdrop doesn't need a NameFromLock() per entry.
+struct wbBackdropEntry {
+    struct MinNode wbe_Node;    // In .backdrop order.
+    struct MinNode wbe_Hash;    // In the wbb_Index bucket for wbe_Key.
+    struct MinNode wbe_Pending; // In wbb_Pending, while wbe_Lock is BNULL.
+    BPTR           wbe_Lock;    // BNULL until resolved.
+    ULONG          wbe_Key;     // wbBackdropHash() of wbe_Path.
+    STRPTR         wbe_Path;    // ":dir/file"
+};
+
+#define wbBackdropFromNode(node) ((struct wbBackdropEntry *)((UBYTE *)(node) - offsetof(struct wbBackdropEntry, wbe_Node)))
+#define wbBackdropFromHash(node) ((struct wbBackdropEntry *)((UBYTE *)(node) - offsetof(struct wbBackdropEntry, wbe_Hash)))
+#define wbBackdropFromPending(node) ((struct wbBackdropEntry *)((UBYTE *)(node) - offsetof(struct wbBackdropEntry, wbe_Pending)))
+
+#define WBBACKDROP_INDEX    16
+
+// Key of a volume relative path (":dir/file"), continued from 'hash' (0 to
+// start). Names are case insensitive, and so is the key. Continuing the key
+// of a drawer from wbBackdropHashDir() with a name in it gives the key of
+// that name, so a drawer's icons can be keyed without a NameFromLock() each.
+ULONG wbBackdropHash(ULONG hash, CONST_STRPTR path);
+// Key of a drawer's path (absolute, or volume relative), to continue with a name.
+ULONG wbBackdropHashDir(CONST_STRPTR path);
+// wbBackdropHashDir() of the drawer that a volume relative path is in.
+ULONG wbBackdropHashParent(CONST_STRPTR path);
+
+// The entries of one volume's .backdrop, indexed by the key of their path.
+struct wbBackdropList {
+    struct MinList wbb_Entries;
+    struct MinList wbb_Pending;     // Entries not yet locked.
+    struct MinList wbb_Index[WBBACKDROP_INDEX];
+};
+
+void wbBackdropInit(struct wbBackdropList *backdrops);
+void _wbBackdropLoadCurrent(struct Library *_DOSBase, struct wbBackdropList *backdrops);
 #define wbBackdropLoadCurrent(backdrops) _wbBackdropLoadCurrent(DOSBase, backdrops)
-BOOL _wbBackdropSaveCurrent(struct Library *_DOSBase, struct List *backdrops);
+BOOL _wbBackdropSaveCurrent(struct Library *_DOSBase, struct wbBackdropList *backdrops);
 #define wbBackdropSaveCurrent(backdrops) _wbBackdropSaveCurrent(DOSBase, backdrops)
-void wbBackdropFree(struct List *backdrops);
+void _wbBackdropFree(struct Library *_DOSBase, struct wbBackdropList *backdrops);
+#define wbBackdropFree(backdrops) _wbBackdropFree(DOSBase, backdrops)
+
+// First entry that has not been locked yet, or NULL.
+struct wbBackdropEntry *wbBackdropPending(struct wbBackdropList *backdrops);
+// Is an entry that can't be locked, with this IoErr(), gone for good?
+static inline BOOL wbBackdropStale(LONG err)
+{
+    return err == ERROR_OBJECT_NOT_FOUND || err == ERROR_DIR_NOT_FOUND;
+}
+// Lock the path of an entry; the current directory must be on its volume.
+// If the path can't be locked, NULL is returned with IoErr() set. A stale
+// entry (see wbBackdropStale()) is deleted; any other failure leaves the
+// entry pending, moved to the back of wbb_Pending, to be retried later.
+struct wbBackdropEntry *_wbBackdropResolveCurrent(struct Library *_DOSBase, struct wbBackdropList *backdrops, struct wbBackdropEntry *wbe);
+#define wbBackdropResolveCurrent(backdrops, wbe) _wbBackdropResolveCurrent(DOSBase, backdrops, wbe)
 
-BOOL _wbBackdropContains(struct Library *_DOSBase, struct List *backdrops, BPTR lock);
-#define wbBackdropContains(backdrops, lock) _wbBackdropContains(DOSBase, backdrops, lock)
-BOOL _wbBackdropAdd(struct Library *_DOSBase, struct List *backdrops, BPTR lock);
+// Lock the pending entries with this key. Returns TRUE if any of them were
+// stale, and so were deleted.
+BOOL _wbBackdropResolveKeyCurrent(struct Library *_DOSBase, struct wbBackdropList *backdrops, ULONG key);
+#define wbBackdropResolveKeyCurrent(backdrops, key) _wbBackdropResolveKeyCurrent(DOSBase, backdrops, key)
+
+// 'key' is the wbBackdropHash() of the lock's path. Only resolved entries
+// with that key are considered, and SameLock() only confirms a match.
+BOOL _wbBackdropContains(struct Library *_DOSBase, struct wbBackdropList *backdrops, ULONG key, BPTR lock);
+#define wbBackdropContains(backdrops, key, lock) _wbBackdropContains(DOSBase, backdrops, key, lock)
+BOOL _wbBackdropAdd(struct Library *_DOSBase, struct wbBackdropList *backdrops, BPTR lock);
 #define wbBackdropAdd(backdrops, lock) _wbBackdropAdd(DOSBase, backdrops, lock)
-BOOL _wbBackdropDel(struct Library *_DOSBase, struct List *backdrops, BPTR lock);
-#define wbBackdropDel(backdrops, lock) _wbBackdropDel(DOSBase, backdrops, lock)
-BOOL _wbBackdropNext(struct Library *_DOSBase, struct List *backdrops, BPTR lock, BPTR *next_ptr);
-#define wbBackdropNext(backdrops, lock, next_ptr) _wbBackdropNext(DOSBase, backdrops, lock, next_ptr)
+BOOL _wbBackdropDel(struct Library *_DOSBase, struct wbBackdropList *backdrops, ULONG key, BPTR lock);
+#define wbBackdropDel(backdrops, key, lock) _wbBackdropDel(DOSBase, backdrops, key, lock)
+
+// Entry after 'wbe' (or the first, if 'wbe' is NULL), or NULL at the end.
+// 'wbe' may be deleted once this returns.
+struct wbBackdropEntry *wbBackdropNext(struct wbBackdropList *backdrops, struct wbBackdropEntry *wbe);
@@ -28,27 +28,46 @@
 #include "workbook_intern.h"
 #include "wbcurrent.h"
 #include "wbinfo.h"
+#include "wbworker.h"
 #include "classes.h"
 
+// List view texts, allocated the first time an icon is shown in a list.
+struct wbIconList {
+    struct IntuiText wil_Label;
+    struct IntuiText wil_Meta;
+    char wil_MetaText[/* size */ 6 + 1 + /* prot */ 8 + 1 + 20 + 1];
+};
+
 struct wbIcon {
-    BPTR               ParentLock;
-    STRPTR             File;
-    struct DiskObject *DiskObject;
+    // Used by hit-testing, layout and rendering.
+    struct wbSetNode SetNode;   // Membership of our WBSet.
+    struct Rectangle  HitBox;  // Icon image hit box, which does not include label.
+    BOOL ListView;
+    struct DiskObject *DiskObject;  // NULL if shed under low memory.
+    UBYTE              DoType;      // Copies of DiskObject fields, which
+    LONG               CurrentX;    // are needed even when it is shed.
+    LONG               CurrentY;
     STRPTR             Label;
     struct Screen     *Screen;
+    struct wbIconList *List;    // NULL until first shown as a list.
+    IPTR ListLabelWidth;
+    struct Rectangle  IconHitBox;   // Icon view layout, kept from the DiskObject
+    UWORD             IconWidth;    // so that a shed icon can be laid out
+    UWORD             IconHeight;   // without reloading it.
+
+    APTR               Pool;        // List is allocated from this.
+    struct wbStringTable *Strings;  // File and Label are interned in this.
+    struct wbSharedLock *Parent;    // Reference to the containing drawer's lock.
+    BPTR               ParentLock;  // Parent->wsl_Lock, or BNULL for volumes.
+    STRPTR             File;
 
     BPTR BackdropLock;    // Lock for the icon on the backdrop.
+    ULONG BackdropKey;    // wbBackdropHash() of our path, for WBBM_LockIs.
 
-    struct Rectangle  HitBox;  // Icon image hit box, which does not include label.
-    BOOL ListView;
-    IPTR ListLabelWidth;
-    struct IntuiText ListILabel;
-    struct IntuiText ListIMeta;
     // Cached FileInfoBlock data
     LONG FibProtection;
     LONG FibSize;
     struct DateStamp FibDateStamp;
-    char ListLabelMeta[/* size */ 6 + 1 + /* prot */ 8 + 1 + 20 + 1];
 
     struct timeval LastActive;
 };
@@ -100,62 +119,176 @@ static BOOL _DevNameFromLock(struct WorkbookBase *wb, BPTR lock, STRPTR buffer,
 #define DevNameFromLock(a, b, c, d) _DevNameFromLock(wb, a, b, c, d)
 #endif // !__amigaos4__
 
+static AROS_UFH3(void, wbIcon_LocalePutChar,
+    AROS_UFHA(struct Hook *, hook, A0),
+    AROS_UFHA(struct Locale *, locale, A2),
+    AROS_UFHA(void *, c, A1))
+{
+    AROS_USERFUNC_INIT
+
+    STRPTR cp = hook->h_Data;
+    *(cp++) = (char)(IPTR)c;
+    *cp = 0;
+    hook->h_Data = cp;
+
+    AROS_USERFUNC_EXIT
+}
+
+// Build the list view texts. This is only done once an icon is
+// first shown in a list, as most icons never are.
+static struct wbIconList *wbIcon_ListNew(Class *cl, Object *obj)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbIcon *my = INST_DATA(cl, obj);
+
+    struct wbIconList *list = wbAllocPooled(my->Pool, sizeof(*list));
+    if (list == NULL) {
+        return NULL;
+    }
+
+    char prottext[9]={0};
+    CONST_STRPTR protbits = "xsparwed";
+    for (int i = 0; i < 8; i++) {
+        // Lower 4 bits are inverted for display purposes.
+        if ((my->FibProtection ^ 0xf) & (1 << i)) {
+            prottext[7-i] = protbits[7-i];
+        } else {
+            prottext[7-i] = '-';
+        }
+    }
+
+    LONG size = my->FibSize;
+    if (my->DoType == WBDRAWER || my->DoType == WBGARBAGE) {
+        snprintf(list->wil_MetaText, sizeof(list->wil_MetaText), "Drawer %s ", prottext);
+    } else {
+        if (size <= 999999) {
+            snprintf(list->wil_MetaText, sizeof(list->wil_MetaText), "%6u %s ", (unsigned)size, prottext);
+        } else if (size < 999 * 1000 * 1000) {
+            snprintf(list->wil_MetaText, sizeof(list->wil_MetaText), "%3u.%uM %s ",
+                    (unsigned)(size / 1000 / 1000),
+                    (unsigned)((size / 1000 / 100) % 10),
+                    prottext);
+        } else {
+            snprintf(list->wil_MetaText, sizeof(list->wil_MetaText), "%u.%03uG %s ",
+                (unsigned)(size / 1000 / 1000 / 1000),
+                (unsigned)((size / 1000 / 1000) % 1000),
+                prottext);
+        }
+    }
+    struct Hook datehook = {
+        .h_Entry = (ULONG(*)())wbIcon_LocalePutChar,
+        .h_Data = &list->wil_MetaText[6 + 1 + 8 + 1],
+    };
+    struct Locale *locale = OpenLocale(NULL);
+    if (locale) {
+        FormatDate(locale, "%d-%b-%Y %X", &my->FibDateStamp, &datehook);
+        CloseLocale(locale);
+    }
+
+    return list;
+}
+
 static void wbIcon_UpdateAsList(Class *cl, Object *obj)
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
     struct wbIcon *my = INST_DATA(cl, obj);
 
-    struct DrawInfo *dri = GetScreenDrawInfo(my->Screen);
-    if (!dri) {
-        return;
+    ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
+
+    // A new one is only published once it is complete, as GM_RENDER
+    // may be drawing from input.device. If it can't be made, the icon
+    // is still laid out as a list entry, but only with its label, and
+    // isn't drawn.
+    struct wbIconList *list = my->List;
+    BOOL fresh = FALSE;
+    if (list == NULL) {
+        list = wbIcon_ListNew(cl, obj);
+        fresh = (list != NULL);
     }
 
-    my->ListILabel = (struct IntuiText){
-        .FrontPen = dri->dri_Pens[TEXTPEN],
-        .BackPen = dri->dri_Pens[BACKGROUNDPEN],
+    struct IntuiText label = {
         .DrawMode = JAM2,
         .LeftEdge = 0,
         .TopEdge = 0,
         .ITextFont = my->Screen->Font,
         .IText = my->Label,
     };
-    my->ListIMeta = (struct IntuiText){
-        .FrontPen = dri->dri_Pens[TEXTPEN],
-        .BackPen = dri->dri_Pens[BACKGROUNDPEN],
-        .DrawMode = JAM2,
-        .LeftEdge = 0,
-        .TopEdge = 0,
-        .ITextFont = my->Screen->Font,
-        .IText = my->ListLabelMeta,
-    };
 
     my->HitBox = (struct Rectangle){
-        .MaxX = IntuiTextLength(&my->ListILabel),
+        .MaxX = IntuiTextLength(&label),
         .MaxY = my->Screen->Font->ta_YSize,
     };
 
     D(bug("%s: %s %s [hitbox (%ld,%ld)-(%ld,%ld)]\n",
-                my->File, my->Label, my->ListLabelMeta,
+                my->File, my->Label, list ? list->wil_MetaText : (char *)"(no list data)",
                 (IPTR)my->HitBox.MinX, (IPTR)my->HitBox.MinY,
                 (IPTR)my->HitBox.MaxX, (IPTR)my->HitBox.MaxY));
 
     // FIXME: This should be from the (fixed width) screen font.
     const LONG ta_XSize = 8;
 
+    ULONG width = my->ListLabelWidth;
+    if (list) {
+        width += STRLEN(list->wil_MetaText);
+    }
+
     SetAttrs(obj,
-            GA_Width, (my->ListLabelWidth + STRLEN(my->ListLabelMeta))*ta_XSize,
+            GA_Width, width*ta_XSize,
             GA_Height, my->Screen->Font->ta_YSize,
             TAG_END);
 
+    if (list == NULL) {
+        return;
+    }
+
+    struct DrawInfo *dri = GetScreenDrawInfo(my->Screen);
+    if (!dri) {
+        // Nothing to draw the texts with, so don't keep them half made.
+        if (fresh) {
+            wbFreePooled(my->Pool, list);
+        }
+        return;
+    }
+
+    label.FrontPen = dri->dri_Pens[TEXTPEN];
+    label.BackPen = dri->dri_Pens[BACKGROUNDPEN];
+    struct IntuiText meta = {
+        .FrontPen = dri->dri_Pens[TEXTPEN],
+        .BackPen = dri->dri_Pens[BACKGROUNDPEN],
+        .DrawMode = JAM2,
+        .LeftEdge = 0,
+        .TopEdge = 0,
+        .ITextFont = my->Screen->Font,
+        .IText = list->wil_MetaText,
+    };
+
     FreeScreenDrawInfo(my->Screen, dri);
+
+    ObtainSemaphore(&wb->wb_Imagery);
+    list->wil_Label = label;
+    list->wil_Meta = meta;
+    my->List = list;
+    ReleaseSemaphore(&wb->wb_Imagery);
 }
 
-static void wbIcon_UpdateAsIcon(Class *cl, Object *obj)
+static struct DiskObject *wbIcon_GetDiskObject(struct WorkbookBase *wb, CONST_STRPTR file, struct Screen *screen)
+{
+    return GetIconTags(file,
+                       ICONGETA_Screen, screen,
+                       ICONGETA_FailIfUnavailable, FALSE,
+                       ICONGETA_GetPaletteMappedIcon, TRUE,
+                       ICONGETA_RemapIcon, TRUE,
+                       ICONGETA_GenerateImageMasks, TRUE,
+                       TAG_END);
+}
+
+// Work out the icon view size and hit box from the imagery, and keep them
+// for when it has been shed.
+static void wbIcon_SizeAsIcon(Class *cl, Object *obj, struct DiskObject *dobj)
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
     struct wbIcon *my = INST_DATA(cl, obj);
     struct Rectangle rect;
-    UWORD icon_w,icon_h;
 
     /* Update the parent's idea of how big we are with labels.
      */
@@ -163,23 +296,63 @@ static void wbIcon_UpdateAsIcon(Class *cl, Object *obj)
     if (label[0] == 0) {
         label = NULL;
     }
-    GetIconRectangleA(&my->Screen->RastPort, my->DiskObject, label, &rect, (struct TagItem *)wbIcon_DrawTags);
+    GetIconRectangleA(&my->Screen->RastPort, dobj, label, &rect, (struct TagItem *)wbIcon_DrawTags);
 
-    icon_w = (rect.MaxX - rect.MinX) + 1;
-    icon_h = (rect.MaxY - rect.MinY) + 1;
+    my->IconWidth = (rect.MaxX - rect.MinX) + 1;
+    my->IconHeight = (rect.MaxY - rect.MinY) + 1;
 
     // Get the hit box (image without label)
-    GetIconRectangleA(&my->Screen->RastPort, my->DiskObject, NULL, &my->HitBox, (struct TagItem *)wbIcon_DrawTags);
-    UWORD image_w = (my->HitBox.MaxX - rect.MinX) + 1;
-    if (icon_w > image_w) {
+    GetIconRectangleA(&my->Screen->RastPort, dobj, NULL, &my->IconHitBox, (struct TagItem *)wbIcon_DrawTags);
+    UWORD image_w = (my->IconHitBox.MaxX - rect.MinX) + 1;
+    if (my->IconWidth > image_w) {
         // Label bigger than icon? Move the hitbox to the center.
-        my->HitBox.MinX += (icon_w - image_w) / 2;
-        my->HitBox.MaxX += (icon_w - image_w) / 2;
+        my->IconHitBox.MinX += (my->IconWidth - image_w) / 2;
+        my->IconHitBox.MaxX += (my->IconWidth - image_w) / 2;
     }
+}
+
+// The icon's imagery, reloaded from disk if it was shed by WBIM_Shed.
+// Only on the Workbook process; GM_RENDER never reloads.
+static struct DiskObject *wbIcon_DiskObject(Class *cl, Object *obj)
+{
+    ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
+
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbIcon *my = INST_DATA(cl, obj);
+
+    if (my->DiskObject == NULL) {
+        BPTR old = CurrentDir(my->ParentLock);
+        struct DiskObject *dobj = wbIcon_GetDiskObject(wb, my->File, my->Screen);
+        CurrentDir(old);
+        D(bug("%s: %s: Reloaded => %p\n", __func__, my->File, dobj));
+        ObtainSemaphore(&wb->wb_Imagery);
+        my->DiskObject = dobj;
+        ReleaseSemaphore(&wb->wb_Imagery);
+    }
+
+    if (my->DiskObject != NULL) {
+        my->DiskObject->do_CurrentX = my->CurrentX;
+        my->DiskObject->do_CurrentY = my->CurrentY;
+    }
+
+    return my->DiskObject;
+}
+
+// Laid out from the size kept by wbIcon_SizeAsIcon(), so a shed icon is
+// not reloaded here - its window does that, with WBIM_Reload, once the
+// icon is in view.
+static void wbIcon_UpdateAsIcon(Class *cl, Object *obj)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbIcon *my = INST_DATA(cl, obj);
+    UWORD icon_w = my->IconWidth;
+    UWORD icon_h = my->IconHeight;
+
+    my->HitBox = my->IconHitBox;
 
     D(bug("%s: %ldx%ld @%ld,%ld [hitbox (%ld,%ld)-(%ld,%ld)] (%s)\n",
                 my->File, (IPTR)icon_w, (IPTR)icon_h,
-                (IPTR)my->DiskObject->do_CurrentX, (IPTR)my->DiskObject->do_CurrentY,
+                (IPTR)my->CurrentX, (IPTR)my->CurrentY,
                 (IPTR)my->HitBox.MinX, (IPTR)my->HitBox.MinY,
                 (IPTR)my->HitBox.MaxX, (IPTR)my->HitBox.MaxY,
                 my->Label));
@@ -201,19 +374,28 @@ static void wbIcon_Update(Class *cl, Object *obj)
     }
 }
 
-static AROS_UFH3(void, wbIcon_LocalePutChar,
-    AROS_UFHA(struct Hook *, hook, A0),
-    AROS_UFHA(struct Locale *, locale, A2),
-    AROS_UFHA(void *, c, A1))
+// Backdrop key of 'file' in a drawer. A window's shared lock already has
+// the key of its path; otherwise (ie left out icons) the drawer is named.
+static ULONG wbIcon_BackdropKey(struct WorkbookBase *wb, struct wbSharedLock *parent, BPTR parentlock, CONST_STRPTR file)
 {
-    AROS_USERFUNC_INIT
+    ULONG hash;
 
-    STRPTR cp = hook->h_Data;
-    *(cp++) = (char)(IPTR)c;
-    *cp = 0;
-    hook->h_Data = cp;
+    if (parent != NULL && parent->wsl_Hashed) {
+        hash = parent->wsl_Hash;
+    } else {
+        STRPTR path = wbAbspathLock(parentlock);
+        if (path == NULL) {
+            return 0;
+        }
+        hash = wbBackdropHashDir(path);
+        FreeVec(path);
+        if (parent != NULL) {
+            parent->wsl_Hash = hash;
+            parent->wsl_Hashed = TRUE;
+        }
+    }
 
-    AROS_USERFUNC_EXIT
+    return wbBackdropHash(hash, file);
 }
 
 // OM_NEW
@@ -226,9 +408,12 @@ static IPTR WBIcon__OM_NEW(Class *cl, Object *obj, struct opSet *ops)
     STRPTR file = (STRPTR)GetTagData(WBIA_File, (IPTR)NULL, ops->ops_AttrList);
     STRPTR label= (STRPTR)GetTagData(WBIA_Label, (IPTR)NULL, ops->ops_AttrList);
     BPTR parentlock   = (BPTR)GetTagData(WBIA_ParentLock, (IPTR)BNULL, ops->ops_AttrList);
+    struct wbSharedLock *parent = (struct wbSharedLock *)GetTagData(WBIA_ParentShare, (IPTR)NULL, ops->ops_AttrList);
     struct Screen *screen = (struct Screen *)GetTagData(WBIA_Screen, (IPTR)NULL, ops->ops_AttrList);
     BOOL listview = (BOOL)GetTagData(WBIA_ListView, (IPTR)FALSE, ops->ops_AttrList);
     ULONG listlabelwidth = (ULONG)GetTagData(WBIA_ListLabelWidth, (IPTR)15, ops->ops_AttrList);
+    APTR pool = (APTR)GetTagData(WBIA_Pool, (IPTR)NULL, ops->ops_AttrList);
+    struct wbStringTable *strings = (struct wbStringTable *)GetTagData(WBIA_Strings, (IPTR)NULL, ops->ops_AttrList);
     LONG protection;
     LONG size;
     struct DateStamp datestamp;
@@ -237,7 +422,18 @@ static IPTR WBIcon__OM_NEW(Class *cl, Object *obj, struct opSet *ops)
         return 0;
     }
 
+    if (parent != NULL) {
+        parentlock = parent->wsl_Lock;
+    }
+
     BPTR backdrop_lock = BNULL;
+    ULONG backdrop_key = 0;
+    struct TagItem *key_tag = FindTagItem(WBIA_BackdropKey, ops->ops_AttrList);
+    if (key_tag != NULL) {
+        backdrop_key = (ULONG)key_tag->ti_Data;
+    } else if (parentlock != BNULL) {
+        backdrop_key = wbIcon_BackdropKey(wb, parent, parentlock, file);
+    }
 
     struct DiskObject *diskobject = NULL;
     BPTR old = CurrentDir(parentlock);
@@ -248,7 +444,7 @@ static IPTR WBIcon__OM_NEW(Class *cl, Object *obj, struct opSet *ops)
             // We're a volume, and always on the backdrop.
             backdrop_lock = lock;
         } else {
-            BOOL isBackdrop = DoMethod(wb->wb_Backdrop, WBBM_LockIs, lock);
+            BOOL isBackdrop = DoMethod(wb->wb_Backdrop, WBBM_LockIs, lock, backdrop_key);
             if (isBackdrop) {
                 backdrop_lock = lock;
             }
@@ -268,20 +464,14 @@ static IPTR WBIcon__OM_NEW(Class *cl, Object *obj, struct opSet *ops)
         }
     }
     if (ok) {
-        diskobject = GetIconTags(file,
-                               ICONGETA_Screen, screen,
-                               ICONGETA_FailIfUnavailable, FALSE,
-                               ICONGETA_GetPaletteMappedIcon, TRUE,
-                               ICONGETA_RemapIcon, TRUE,
-                               ICONGETA_GenerateImageMasks, TRUE,
-                               TAG_END);
+        diskobject = wbIcon_GetDiskObject(wb, file, screen);
     }
     CurrentDir(old);
     if (diskobject == NULL) {
         return 0;
     }
 
-    file = StrDup(file);
+    file = (STRPTR)wbStringIntern(strings, file);
     if (!file) {
         if (backdrop_lock != BNULL) {
             UnLock(backdrop_lock);
@@ -293,24 +483,29 @@ static IPTR WBIcon__OM_NEW(Class *cl, Object *obj, struct opSet *ops)
     if (label == NULL) {
         label = file;
     }
-    label = StrDup(label);
+    // Usually the same name as the file, so shared with it.
+    label = (STRPTR)wbStringIntern(strings, label);
     if (label == NULL) {
         if (backdrop_lock != BNULL) {
             UnLock(backdrop_lock);
         }
-        FreeVec(file);
+        wbStringRelease(strings, file);
         FreeDiskObject(diskobject);
         return 0;
     }
 
-    if (parentlock != BNULL) {
-        parentlock = DupLock(parentlock);
-        if (parentlock == BNULL) {
+    if (parent != NULL) {
+        parent = wbSharedLockRef(parent);
+    } else if (parentlock != BNULL) {
+        // Not given a shared drawer lock, so this needs a lock of its own.
+        // (The root window shares one per drawer between its left out icons.)
+        parent = wbSharedLockNew(wb, parentlock);
+        if (parent == NULL) {
             if (backdrop_lock != BNULL) {
                 UnLock(backdrop_lock);
             }
-            FreeVec(label);
-            FreeVec(file);
+            wbStringRelease(strings, label);
+            wbStringRelease(strings, file);
             FreeDiskObject(diskobject);
             return 0;
         }
@@ -318,24 +513,28 @@ static IPTR WBIcon__OM_NEW(Class *cl, Object *obj, struct opSet *ops)
 
     obj = (Object *)DoSuperMethodA(cl, obj, (Msg)ops);
     if (obj == NULL) {
-        if (parentlock != BNULL) {
-            UnLock(parentlock);
-        }
+        wbSharedLockRelease(wb, parent);
         if (backdrop_lock != BNULL) {
             UnLock(backdrop_lock);
         }
-        FreeVec(label);
-        FreeVec(file);
+        wbStringRelease(strings, label);
+        wbStringRelease(strings, file);
         FreeDiskObject(diskobject);
         return 0;
     }
 
     struct wbIcon *my = INST_DATA(cl, obj);
 
+    my->Pool = pool;
+    my->Strings = strings;
     my->File = file;
     my->Label = label;
-    my->ParentLock = parentlock;
+    my->Parent = parent;
+    my->ParentLock = parent ? parent->wsl_Lock : BNULL;
     my->DiskObject = diskobject;
+    my->DoType = diskobject->do_Type;
+    my->CurrentX = diskobject->do_CurrentX;
+    my->CurrentY = diskobject->do_CurrentY;
     my->Screen = screen;
 
     my->ListView = listview;
@@ -344,57 +543,18 @@ static IPTR WBIcon__OM_NEW(Class *cl, Object *obj, struct opSet *ops)
     my->FibProtection = protection;
     my->FibSize = size;
     my->FibDateStamp = datestamp;
-    my->ListILabel = (struct IntuiText){0};
-    my->ListIMeta  = (struct IntuiText){0};
-
-    char prottext[9]={0};
-    CONST_STRPTR protbits = "xsparwed";
-    for (int i = 0; i < 8; i++) {
-        // Lower 4 bits are inverted for display purposes.
-        if ((my->FibProtection ^ 0xf) & (1 << i)) {
-            prottext[7-i] = protbits[7-i];
-        } else {
-            prottext[7-i] = '-';
-        }
-    }
-
-    if (my->DiskObject->do_Type == WBDRAWER || my->DiskObject->do_Type == WBGARBAGE) {
-        snprintf(my->ListLabelMeta, sizeof(my->ListLabelMeta), "Drawer %s ", prottext);
-    } else {
-        if (size <= 999999) {
-            snprintf(my->ListLabelMeta, sizeof(my->ListLabelMeta), "%6u %s ", (unsigned)size, prottext);
-        } else if (size < 999 * 1000 * 1000) {
-            snprintf(my->ListLabelMeta, sizeof(my->ListLabelMeta), "%3u.%uM %s ",
-                    (unsigned)(size / 1000 / 1000),
-                    (unsigned)((size / 1000 / 100) % 10),
-                    prottext);
-        } else {
-            snprintf(my->ListLabelMeta, sizeof(my->ListLabelMeta), "%u.%03uG %s ",
-                (unsigned)(size / 1000 / 1000 / 1000),
-                (unsigned)((size / 1000 / 1000) % 1000),
-                prottext);
-        }
-    }
-    struct Hook datehook = {
-        .h_Entry = (ULONG(*)())wbIcon_LocalePutChar,
-        .h_Data = &my->ListLabelMeta[6 + 1 + 8 + 1],
-    };
-    struct Locale *locale = OpenLocale(NULL);
-    if (locale) {
-        FormatDate(locale, "%d-%b-%Y %X", &my->FibDateStamp, &datehook);
-        CloseLocale(locale);
-    }
+    my->List = NULL;
 
     my->BackdropLock = backdrop_lock;
-    if (my->BackdropLock != BNULL) {
-        if (my->ParentLock == BNULL) {
-            // Add to the WBApp's volume list.
-            DoMethod(wb->wb_Backdrop, WBBM_VolumeAdd, my->BackdropLock);
-        } else {
-            DoMethod(wb->wb_Backdrop, WBBM_LockAdd, my->BackdropLock);
-        }
+    my->BackdropKey = backdrop_key;
+    if (my->BackdropLock != BNULL && my->ParentLock == BNULL) {
+        // Add to the WBApp's volume list.
+        // (Other backdrop icons were found by WBBM_LockIs, so are already there.)
+        DoMethod(wb->wb_Backdrop, WBBM_VolumeAdd, my->BackdropLock);
     }
 
+    // Even in a list, so that switching to icons needs no imagery.
+    wbIcon_SizeAsIcon(cl, obj, diskobject);
     wbIcon_Update(cl, obj);
 
     // Do any OM_SETs
@@ -415,7 +575,7 @@ static IPTR WBIcon__OM_DISPOSE(Class *cl, Object *obj, Msg msg)
         // If this icon on the backdrop is going away, it's because the volume is unmounted.
         DoMethod(wb->wb_Backdrop, WBBM_VolumeDel, my->BackdropLock);
     } else {
-        UnLock(my->ParentLock);
+        wbSharedLockRelease(wb, my->Parent);
     }
 
     if (my->BackdropLock != BNULL) {
@@ -425,13 +585,16 @@ static IPTR WBIcon__OM_DISPOSE(Class *cl, Object *obj, Msg msg)
     }
 
     ASSERT(my->Label != NULL);
-    FreeVec(my->Label);
+    wbStringRelease(my->Strings, my->Label);
 
     ASSERT(my->File != NULL);
-    FreeVec(my->File);
+    wbStringRelease(my->Strings, my->File);
+
+    if (my->DiskObject != NULL) {
+        FreeDiskObject(my->DiskObject);
+    }
 
-    ASSERT(my->DiskObject != NULL);
-    FreeDiskObject(my->DiskObject);
+    wbFreePooled(my->Pool, my->List);
 
     return DoSuperMethodA(cl, obj, msg);
 }
@@ -462,13 +625,13 @@ static IPTR WBIcon__OM_GET(Class *cl, Object *obj, struct opGet *opg)
         *(struct DateStamp *)(opg->opg_Storage) = my->FibDateStamp;
         break;
     case WBIA_DoType:
-        *(opg->opg_Storage) = (IPTR)my->DiskObject->do_Type;
+        *(opg->opg_Storage) = (IPTR)my->DoType;
         break;
     case WBIA_DoCurrentX:
-        *(opg->opg_Storage) = (IPTR)my->DiskObject->do_CurrentX;
+        *(opg->opg_Storage) = (IPTR)my->CurrentX;
         break;
     case WBIA_DoCurrentY:
-        *(opg->opg_Storage) = (IPTR)my->DiskObject->do_CurrentY;
+        *(opg->opg_Storage) = (IPTR)my->CurrentY;
         break;
     case WBIA_HitBox:
         *(struct Rectangle *)(opg->opg_Storage) = my->HitBox;
@@ -476,6 +639,15 @@ static IPTR WBIcon__OM_GET(Class *cl, Object *obj, struct opGet *opg)
     case WBIA_Backdrop:
         *(opg->opg_Storage) = (IPTR)(my->BackdropLock != BNULL);
         break;
+    case WBIA_BackdropLock:
+        *(opg->opg_Storage) = (IPTR)my->BackdropLock;
+        break;
+    case WBIA_BackdropKey:
+        *(opg->opg_Storage) = (IPTR)my->BackdropKey;
+        break;
+    case WBIA_SetNode:
+        *(opg->opg_Storage) = (IPTR)&my->SetNode;
+        break;
     default:
         rc = DoSuperMethodA(cl, obj, (Msg)opg);
         break;
@@ -511,10 +683,10 @@ static IPTR WBIcon__OM_SET(Class *cl, Object *obj, struct opSet *ops)
             listlabelwidth = (BOOL)ti->ti_Data;
             break;
         case WBIA_DoCurrentX:
-            my->DiskObject->do_CurrentX = (LONG)ti->ti_Data;
+            my->CurrentX = (LONG)ti->ti_Data;
             break;
         case WBIA_DoCurrentY:
-            my->DiskObject->do_CurrentY = (LONG)ti->ti_Data;
+            my->CurrentY = (LONG)ti->ti_Data;
             break;
         case WBIA_Backdrop:
             backdrop = (BOOL)ti->ti_Data;
@@ -544,7 +716,7 @@ static IPTR WBIcon__OM_SET(Class *cl, Object *obj, struct opSet *ops)
         } else {
             BPTR lock = my->BackdropLock;
             my->BackdropLock = BNULL;
-            BOOL ok = DoMethod(wb->wb_Backdrop, WBBM_LockDel, lock);
+            BOOL ok = DoMethod(wb->wb_Backdrop, WBBM_LockDel, lock, my->BackdropKey);
             if (ok) {
                 D(bug("%s: %s - Removed from .backdrop for my volume\n", __func__, my->File));
                 DoMethod(wb->wb_App, WBAM_InvalidateContents, lock);
@@ -598,14 +770,20 @@ static IPTR WBIcon__GM_RENDER(Class *cl, Object *obj, struct gpRender *gpr)
     if (rp) {
         /* Clip to the window for drawing */
         clip = wbClipWindow(wb, win);
+        // This may be on input.device's task (ie scrolling), so nothing
+        // shed by WBIM_Shed is rebuilt here. A shed icon isn't drawn
+        // until its window restores it with WBIM_Reload.
+        ObtainSemaphoreShared(&wb->wb_Imagery);
         if (my->ListView) {
-            struct IntuiText label = my->ListILabel;
-            if (gadget->Flags & GFLG_SELECTED) {
-                label.FrontPen = my->ListILabel.BackPen;
-                label.BackPen = my->ListILabel.FrontPen;
+            if (my->List) {
+                struct IntuiText label = my->List->wil_Label;
+                if (gadget->Flags & GFLG_SELECTED) {
+                    label.FrontPen = my->List->wil_Label.BackPen;
+                    label.BackPen = my->List->wil_Label.FrontPen;
+                }
+                PrintIText(rp, &label, x, y);
+                PrintIText(rp, &my->List->wil_Meta, x + 8 * my->ListLabelWidth, y);
             }
-            PrintIText(rp, &label, x, y);
-            PrintIText(rp, &my->ListIMeta, x + 8 * my->ListLabelWidth, y);
         } else {
             STRPTR label = my->Label;
             if (label[0] == 0) {
@@ -616,8 +794,11 @@ static IPTR WBIcon__GM_RENDER(Class *cl, Object *obj, struct gpRender *gpr)
                 { TAG_MORE, (IPTR)&wbIcon_DrawTags[0] },
             };
             ULONG state = (gadget->Flags & GFLG_SELECTED) ? IDS_SELECTED : IDS_NORMAL;
-            DrawIconStateA(rp, my->DiskObject, label, x, y, state, tags);
+            if (my->DiskObject) {
+                DrawIconStateA(rp, my->DiskObject, label, x, y, state, tags);
+            }
         }
+        ReleaseSemaphore(&wb->wb_Imagery);
         wbUnclipWindow(wb, win, clip);
 
         if (gpr->gpr_RPort == NULL) {
@@ -748,11 +929,10 @@ static IPTR WBIcon__GM_GOACTIVE(Class *cl, Object *obj, struct gpInput *gpi)
     {
         D(bug("%s: Double-clicked => %lx\n", __func__, (IPTR)wb->wb_App));
 
+        // The WBApp will open (and then de-select) all
+        // selected icons from the Workbench process.
         SetAttrs(obj, GA_Selected, TRUE, TAG_END);
-        IPTR msg[] = { WBIM_Open };
-        DoMethod(wb->wb_App, WBAM_ForSelected, (Msg)msg);
-        // De-select all.
-        DoMethod(wb->wb_App, WBAM_ClearSelected);
+        DoMethod(wb->wb_App, WBAM_OpenSelected);
     } else {
         if (gpi->gpi_IEvent != NULL) {
             my->LastActive = gpi->gpi_IEvent->ie_TimeStamp;
@@ -813,11 +993,44 @@ static IPTR WBIcon__GM_GOINACTIVE(Class *cl, Object *obj, struct gpGoInactive *g
 // WBIM_Open
 static IPTR WBIcon__WBIM_Open(Class *cl, Object *obj, Msg msg)
 {
+    ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
+
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
     struct wbIcon *my = INST_DATA(cl, obj);
 
-    // NOTE! We may _not_ be in Process() context, so we can't DupLock() for NP_CurrentDir.
-    // Sigh.
+    switch (my->DoType) {
+    case WBDISK:
+        // fallthrough
+    case WBDRAWER:
+        // fallthrough
+    case WBGARBAGE:
+        {
+            // Open our own drawer windows directly.
+            BPTR pwd = CurrentDir(my->ParentLock);
+            BPTR lock = Lock(my->File, SHARED_LOCK);
+            LONG err = IoErr();
+            CurrentDir(pwd);
+            if (lock == BNULL) {
+                wbPopupIoErr(wb, "Open", err, my->File);
+            } else {
+                DoMethod(wb->wb_App, WBAM_OpenDrawer, lock);
+                UnLock(lock);
+            }
+            D(bug("WBIcon.Open: %s in-process\n", my->File));
+        }
+        return 0;
+    default:
+        break;
+    }
+
+    // Tools and projects are launched by workbench.library, which
+    // may take a while - so do that from the launcher processes.
+    if (DoMethod(wb->wb_App, WBAM_Launch, my->ParentLock, my->File)) {
+        D(bug("WBIcon.Open: %s queued\n", my->File));
+        return 0;
+    }
+
+    // No launcher available, so use a one-shot process.
     D(struct Process *proc =) CreateNewProcTags(
             NP_Name, (IPTR)my->File,
             NP_Entry, (IPTR)wbOpener,
@@ -839,7 +1052,7 @@ static IPTR WBIcon__WBIM_Copy(Class *cl, Object *obj, Msg msg)
     BOOL ok;
 
     // Is this object suitable for a bump copy?
-    switch (my->DiskObject->do_Type) {
+    switch (my->DoType) {
     case WBTOOL:
         // fallthrough
     case WBPROJECT:
@@ -858,9 +1071,14 @@ static IPTR WBIcon__WBIM_Copy(Class *cl, Object *obj, Msg msg)
         break;
     }
 
+    if (ok && DoMethod(wb->wb_App, WBAM_QueueJob, WBJOB_COPY, my->ParentLock, my->File, NULL, 0, 0)) {
+        // The worker will update the window when done.
+        return ok;
+    }
+
     if (ok) {
         BPTR pwd = CurrentDir(my->ParentLock);
-        ok = wbCopyBumpCurrent(my->File);
+        ok = wbCopyBumpCurrent(my->File, NULL, NULL);
         if (!ok) {
             wbPopupIoErr(wb, "Copy", IoErr(), my->File);
         }
@@ -1011,8 +1229,13 @@ static IPTR WBIcon__WBIM_Snapshot(Class *cl, Object *obj, Msg msg)
 
     D(bug("%s: %s\n", __func__, my->File));
 
+    struct DiskObject *dobj = wbIcon_DiskObject(cl, obj);
+    if (dobj == NULL) {
+        return 0;
+    }
+
     BPTR oldLock = CurrentDir(my->ParentLock);
-    PutIconTags(my->File, my->DiskObject, ICONPUTA_OnlyUpdatePosition, TRUE, TAG_END);
+    PutIconTags(my->File, dobj, ICONPUTA_OnlyUpdatePosition, TRUE, TAG_END);
     CurrentDir(oldLock);
 
     return 0;
@@ -1028,11 +1251,16 @@ static IPTR WBIcon__WBIM_Unsnapshot(Class *cl, Object *obj, Msg msg)
 
     D(bug("%s: %s\n", __func__, my->File));
 
-    my->DiskObject->do_CurrentX = (LONG)NO_ICON_POSITION;
-    my->DiskObject->do_CurrentY = (LONG)NO_ICON_POSITION;
+    my->CurrentX = (LONG)NO_ICON_POSITION;
+    my->CurrentY = (LONG)NO_ICON_POSITION;
+
+    struct DiskObject *dobj = wbIcon_DiskObject(cl, obj);
+    if (dobj == NULL) {
+        return 0;
+    }
 
     BPTR oldLock = CurrentDir(my->ParentLock);
-    PutIconTags(my->File, my->DiskObject, ICONPUTA_OnlyUpdatePosition, TRUE, TAG_END);
+    PutIconTags(my->File, dobj, ICONPUTA_OnlyUpdatePosition, TRUE, TAG_END);
     CurrentDir(oldLock);
 
     return 0;
@@ -1082,7 +1310,7 @@ static IPTR WBIcon__WBIM_Delete(Class *cl, Object *obj, Msg msg)
     LONG err;
 
     // Is this object suitable for a delete?
-    switch (my->DiskObject->do_Type) {
+    switch (my->DoType) {
     case WBTOOL:
         // fallthrough
     case WBPROJECT:
@@ -1108,9 +1336,14 @@ static IPTR WBIcon__WBIM_Delete(Class *cl, Object *obj, Msg msg)
         err = ERROR_OBJECT_WRONG_TYPE;
     }
 
+    if (ok && DoMethod(wb->wb_App, WBAM_QueueJob, WBJOB_DELETE, my->ParentLock, my->File, NULL, 0, 0)) {
+        // The worker will update the window when done.
+        return 0;
+    }
+
     if (ok) {
         BPTR pwd = CurrentDir(my->ParentLock);
-        ok = wbDeleteFromCurrent(my->File, FALSE);
+        ok = wbDeleteFromCurrent(my->File, FALSE, NULL);
         err = IoErr();
         CurrentDir(pwd);
     }
@@ -1182,12 +1415,12 @@ static IPTR WBIcon__WBIM_MoveBy(Class *cl, Object *obj, struct wbim_MoveBy *wbim
     struct wbIcon *my = INST_DATA(cl, obj);
 
     IPTR rc = WBIF_OK;
-    if (my->DiskObject->do_CurrentX != (LONG)NO_ICON_POSITION &&
-        my->DiskObject->do_CurrentY != (LONG)NO_ICON_POSITION) {
-        my->DiskObject->do_CurrentX += wbimm->wbimm_DeltaX;
-        my->DiskObject->do_CurrentY += wbimm->wbimm_DeltaY;
+    if (my->CurrentX != (LONG)NO_ICON_POSITION &&
+        my->CurrentY != (LONG)NO_ICON_POSITION) {
+        my->CurrentX += wbimm->wbimm_DeltaX;
+        my->CurrentY += wbimm->wbimm_DeltaY;
 
-        D(bug("%s: Moved %s by %ld,%ld to %ld,%ld\n", __func__, my->File, wbimm->wbimm_DeltaX, wbimm->wbimm_DeltaY, my->DiskObject->do_CurrentX, my->DiskObject->do_CurrentY));
+        D(bug("%s: Moved %s by %ld,%ld to %ld,%ld\n", __func__, my->File, wbimm->wbimm_DeltaX, wbimm->wbimm_DeltaY, my->CurrentX, my->CurrentY));
         // Request a refresh of the window.
         rc = WBIF_REFRESH;
     } else {
@@ -1197,6 +1430,53 @@ static IPTR WBIcon__WBIM_MoveBy(Class *cl, Object *obj, struct wbim_MoveBy *wbim
     return rc;
 }
 
+// WBIM_Shed
+static IPTR WBIcon__WBIM_Shed(Class *cl, Object *obj, Msg msg)
+{
+    ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
+
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbIcon *my = INST_DATA(cl, obj);
+
+    // Both are rebuilt by WBIM_Reload, from disk and from the cached FileInfoBlock data.
+    ObtainSemaphore(&wb->wb_Imagery);
+    struct DiskObject *dobj = my->DiskObject;
+    struct wbIconList *list = my->List;
+    my->DiskObject = NULL;
+    my->List = NULL;
+    ReleaseSemaphore(&wb->wb_Imagery);
+
+    if (dobj != NULL) {
+        FreeDiskObject(dobj);
+    }
+    wbFreePooled(my->Pool, list);
+
+    return (dobj != NULL || list != NULL);
+}
+
+// WBIM_Reload
+static IPTR WBIcon__WBIM_Reload(Class *cl, Object *obj, Msg msg)
+{
+    ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
+
+    struct wbIcon *my = INST_DATA(cl, obj);
+
+    // Only what the current view draws.
+    if (my->ListView) {
+        if (my->List != NULL) {
+            return FALSE;
+        }
+        wbIcon_UpdateAsList(cl, obj);
+        return (my->List != NULL);
+    }
+
+    if (my->DiskObject != NULL) {
+        return FALSE;
+    }
+
+    return (wbIcon_DiskObject(cl, obj) != NULL);
+}
+
 static IPTR WBIcon__WBxM_DragDropped(Class *cl, Object *obj, struct wbxm_DragDropped *wbxmd)
 {
     ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
@@ -1225,7 +1505,7 @@ static IPTR WBIcon__WBxM_DragDropped(Class *cl, Object *obj, struct wbxm_DragDro
 
     BPTR lock = BNULL;
     BPTR oldLock = CurrentDir(my->ParentLock);
-    switch (my->DiskObject->do_Type) {
+    switch (my->DoType) {
     case WBTOOL:
         // fallthrough
     case WBPROJECT:
@@ -1246,9 +1526,12 @@ static IPTR WBIcon__WBxM_DragDropped(Class *cl, Object *obj, struct wbxm_DragDro
         D(wbDebugReportSelected(wb));
         lock = Lock(my->File, SHARED_LOCK);
         if (lock != BNULL) {
-            CurrentDir(lock);
-            ok = wbDropOntoCurrent(args);
-            err = IoErr();
+            ok = DoMethod(wb->wb_App, WBAM_QueueJob, WBJOB_DROP, lock, NULL, args, (LONG)NO_ICON_POSITION, (LONG)NO_ICON_POSITION);
+            if (!ok) {
+                CurrentDir(lock);
+                ok = wbDropOntoCurrent(args, NULL, NULL);
+                err = IoErr();
+            }
             UnLock(lock);
         } else {
             ok = FALSE;
@@ -1298,6 +1581,8 @@ static IPTR WBIcon_dispatcher(Class *cl, Object *obj, Msg msg)
     METHOD_CASE(WBIcon, WBIM_Empty_Trash);
     METHOD_CASE(WBIcon, WBIM_DragDropAdd);
     METHOD_CASE(WBIcon, WBIM_MoveBy);
+    METHOD_CASE(WBIcon, WBIM_Shed);
+    METHOD_CASE(WBIcon, WBIM_Reload);
     METHOD_CASE(WBIcon, WBxM_DragDropped);
     default:               rc = DoSuperMethodA(cl, obj, msg); break;
     }
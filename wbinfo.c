@@ -53,6 +53,7 @@ struct wbInfo {
     LONG id_BytesPerBlock;
     LONG fib_Size;
     LONG fib_NumBlocks;
+    LONG fib_Files;         // Drawers only: entries in the whole tree.
 
     // Updatable items
     LONG do_StackSize;
@@ -211,6 +212,7 @@ enum {
     WBINFO_GADID_BLOCK_FREE,
     WBINFO_GADID_BLOCK_SIZE,
     WBINFO_GADID_BYTE_SIZE,
+    WBINFO_GADID_FILE_COUNT,
     WBINFO_GADID_STACK_SIZE,
     WBINFO_GADID_VOLUME_STATE,
     WBINFO_GADID_ICON,
@@ -345,6 +347,7 @@ static struct Gadget *wbInfoGadgets_icon_left(struct wbInfo *wb, struct Gadget *
 
     IPTR fib_blocks = wb->fib_NumBlocks;
     IPTR fib_bytes = wb->fib_Size;
+    IPTR fib_files = wb->fib_Files;
     IPTR do_stacksize = wb->DiskObject->do_StackSize;
 
     const struct entry devicemap[] = {
@@ -359,6 +362,13 @@ static struct Gadget *wbInfoGadgets_icon_left(struct wbInfo *wb, struct Gadget *
         { 0 },
     };
 
+    const struct entry drawermap[] = {
+        { WBINFO_GADID_BLOCK_SIZE, "    Blocks:", fib_blocks},
+        { WBINFO_GADID_BYTE_SIZE,  "     Bytes:", fib_bytes},
+        { WBINFO_GADID_FILE_COUNT, "     Files:", fib_files},
+        { 0 },
+    };
+
     const struct entry toolmap[] = {
         { WBINFO_GADID_BLOCK_SIZE, "    Blocks:", fib_blocks},
         { WBINFO_GADID_BYTE_SIZE,  "     Bytes:", fib_bytes},
@@ -376,7 +386,7 @@ static struct Gadget *wbInfoGadgets_icon_left(struct wbInfo *wb, struct Gadget *
         break;
     case WBGARBAGE:
     case WBDRAWER:
-        map = emptymap;
+        map = drawermap;
         break;
     case WBTOOL:
     case WBPROJECT:
@@ -1023,9 +1033,13 @@ static void wbInfo_Main(struct wbInfo *wb, CONST_STRPTR file)
     BPTR lock = Lock(wb->File, SHARED_LOCK);
     D(if (lock == BNULL) bug("%s: '%s' lock failed\n", __func__, wb->File));
     if (lock) {
+        BOOL is_drawer = FALSE;
         struct FileInfoBlock *fib = AllocDosObjectTags(DOS_FIB, TAG_END);
         if (fib) {
             if (Examine(lock, fib)) {
+                // Only plain drawers. A volume (ST_ROOT) would be a walk
+                // of the whole disk before the window even opens.
+                is_drawer = (fib->fib_DirEntryType == ST_USERDIR);
                 wb->fib_Protection = fib->fib_Protection;
                 wb->fib_Comment = wbInfo_DupStr(fib->fib_Comment);
                 wb->fib_Size = fib->fib_Size;
@@ -1051,6 +1065,16 @@ static void wbInfo_Main(struct wbInfo *wb, CONST_STRPTR file)
             FreeVec(_idbuff);
         }
 
+        if (is_drawer) {
+            // Add up everything in the drawer.
+            struct wbSize size = { .ws_BlockSize = wb->id_BytesPerBlock };
+            if (wbSizeLock(lock, &size, NULL)) {
+                wb->fib_Size = size.ws_Bytes;
+                wb->fib_NumBlocks = size.ws_Blocks;
+                wb->fib_Files = size.ws_Files;
+            }
+        }
+
         UnLock(lock);
     }
 
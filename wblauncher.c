@@ -0,0 +1,241 @@
+// Copyright 2023, Jason S. McMullan <jason.mcmullan@gmail.com>
+//
+// This code licensed under the MIT License, as follows:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the “Software”), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include <string.h>
+
+#include <proto/dos.h>
+#include <proto/exec.h>
+
+#include <dos/dostags.h>
+
+#ifdef __AROS__
+#include <proto/workbench.h>
+#else
+#include <proto/wb.h>
+#endif
+
+#include "wbcurrent.h"
+#include "wblauncher.h"
+
+extern struct ExecBase *SysBase;
+
+// A launch request, or (if wlm_Dir is BNULL) a control message.
+struct wbLaunchMsg {
+    struct Message wlm_Message;
+    struct wbLauncherSlot *wlm_Slot;    // Startup message only.
+    BPTR   wlm_Dir;                     // DupLock()ed, freed by the launcher.
+    TEXT   wlm_File[1];                 // Extended by the allocation.
+};
+
+struct wbLauncherSlot {
+    struct MsgPort *wls_Port;           // Owned by the launcher process.
+};
+
+struct wbLauncher {
+    struct MsgPort *wl_ReplyPort;       // For startup and shutdown messages.
+    ULONG           wl_Slots;
+    struct wbLauncherSlot wl_Slot[WBLAUNCHER_PROCESSES];
+};
+
+AROS_PROCP(wbLauncher);
+
+// Persistent launcher process.
+//
+// The first message on pr_MsgPort is the startup message from _wbLauncherCreate(),
+// which tells us where to publish our request port. DOS owns pr_MsgPort for packet
+// I/O, so all requests arrive on a private port instead.
+AROS_PROCH(wbLauncher, argstr, argsize, SysBase)
+{
+    AROS_PROCFUNC_INIT
+
+    struct Process *proc = (struct Process *)FindTask(NULL);
+    struct wbLaunchMsg *startup;
+    struct wbLaunchMsg *quit = NULL;
+    struct MsgPort *port;
+
+    WaitPort(&proc->pr_MsgPort);
+    startup = (struct wbLaunchMsg *)GetMsg(&proc->pr_MsgPort);
+
+    APTR DOSBase = OpenLibrary("dos.library", 0);
+    APTR WorkbenchBase = OpenLibrary("workbench.library", 0);
+    port = CreateMsgPort();
+
+    if (DOSBase == NULL || WorkbenchBase == NULL || port == NULL) {
+        if (port)
+            DeleteMsgPort(port);
+        if (WorkbenchBase)
+            CloseLibrary(WorkbenchBase);
+        if (DOSBase)
+            CloseLibrary(DOSBase);
+        startup->wlm_Slot->wls_Port = NULL;
+        Forbid();
+        ReplyMsg(&startup->wlm_Message);
+        return 0;
+    }
+
+    startup->wlm_Slot->wls_Port = port;
+    ReplyMsg(&startup->wlm_Message);
+
+    while (quit == NULL) {
+        struct wbLaunchMsg *wlm;
+
+        WaitPort(port);
+        while ((wlm = (struct wbLaunchMsg *)GetMsg(port)) != NULL) {
+            if (wlm->wlm_Dir == BNULL) {
+                // Shutdown request. Anything queued after it is still handled.
+                quit = wlm;
+                continue;
+            }
+
+            BPTR pwd = CurrentDir(wlm->wlm_Dir);
+            STRPTR abspath = wbAbspathCurrent(wlm->wlm_File);
+            if (abspath != NULL) {
+                D(bug("%s: OpenWorkbenchObject(%s)\n", __func__, abspath));
+                OpenWorkbenchObject(abspath, TAG_END);
+                FreeVec(abspath);
+            }
+            CurrentDir(pwd);
+            UnLock(wlm->wlm_Dir);
+            FreeVec(wlm);
+        }
+    }
+
+    DeleteMsgPort(port);
+    CloseLibrary(WorkbenchBase);
+    CloseLibrary(DOSBase);
+
+    // Don't let our caller unload us before we have exited.
+    Forbid();
+    ReplyMsg(&quit->wlm_Message);
+
+    return 0;
+
+    AROS_PROCFUNC_EXIT
+}
+
+// Send a control message to a launcher, and wait for the reply.
+static void wbLauncherControl(struct wbLauncher *wbl, struct MsgPort *port, struct wbLauncherSlot *slot)
+{
+    struct wbLaunchMsg wlm;
+
+    memset(&wlm, 0, sizeof(wlm));
+    wlm.wlm_Message.mn_Node.ln_Type = NT_MESSAGE;
+    wlm.wlm_Message.mn_ReplyPort = wbl->wl_ReplyPort;
+    wlm.wlm_Message.mn_Length = sizeof(wlm);
+    wlm.wlm_Slot = slot;
+    wlm.wlm_Dir = BNULL;
+
+    PutMsg(port, &wlm.wlm_Message);
+    WaitPort(wbl->wl_ReplyPort);
+    GetMsg(wbl->wl_ReplyPort);
+}
+
+struct wbLauncher *_wbLauncherCreate(struct Library *DOSBase)
+{
+    struct wbLauncher *wbl;
+
+    wbl = AllocVec(sizeof(*wbl), MEMF_ANY | MEMF_CLEAR);
+    if (wbl == NULL) {
+        return NULL;
+    }
+
+    wbl->wl_ReplyPort = CreateMsgPort();
+    if (wbl->wl_ReplyPort == NULL) {
+        FreeVec(wbl);
+        return NULL;
+    }
+
+    for (int i = 0; i < WBLAUNCHER_PROCESSES; i++) {
+        struct wbLauncherSlot *slot = &wbl->wl_Slot[wbl->wl_Slots];
+        struct Process *proc = CreateNewProcTags(
+                NP_Name, (IPTR)"Workbook Launcher",
+                NP_Entry, (IPTR)wbLauncher,
+                TAG_END);
+        if (proc == NULL) {
+            break;
+        }
+
+        wbLauncherControl(wbl, &proc->pr_MsgPort, slot);
+        if (slot->wls_Port == NULL) {
+            break;
+        }
+
+        wbl->wl_Slots++;
+    }
+
+    D(bug("%s: %ld launcher(s)\n", __func__, (IPTR)wbl->wl_Slots));
+
+    if (wbl->wl_Slots == 0) {
+        DeleteMsgPort(wbl->wl_ReplyPort);
+        FreeVec(wbl);
+        return NULL;
+    }
+
+    return wbl;
+}
+
+BOOL _wbLauncherOpen(struct Library *DOSBase, struct wbLauncher *wbl, BPTR dir, CONST_STRPTR file)
+{
+    struct wbLaunchMsg *wlm;
+    LONG len = STRLEN(file);
+
+    if (wbl == NULL || dir == BNULL) {
+        return FALSE;
+    }
+
+    wlm = AllocVec(sizeof(*wlm) + len, MEMF_PUBLIC | MEMF_CLEAR);
+    if (wlm == NULL) {
+        return FALSE;
+    }
+
+    wlm->wlm_Dir = DupLock(dir);
+    if (wlm->wlm_Dir == BNULL) {
+        FreeVec(wlm);
+        return FALSE;
+    }
+
+    CopyMem(file, wlm->wlm_File, len + 1);
+    wlm->wlm_Message.mn_Node.ln_Type = NT_MESSAGE;
+    wlm->wlm_Message.mn_ReplyPort = NULL;
+    wlm->wlm_Message.mn_Length = sizeof(*wlm) + len;
+
+    // Route by filesystem handler, so that all the launches for a device
+    // are serialised by the same process.
+    struct FileLock *fl = BADDR(wlm->wlm_Dir);
+    ULONG slot = ((IPTR)fl->fl_Task >> 4) % wbl->wl_Slots;
+
+    D(bug("%s: %s => launcher %ld\n", __func__, file, (IPTR)slot));
+
+    PutMsg(wbl->wl_Slot[slot].wls_Port, &wlm->wlm_Message);
+
+    return TRUE;
+}
+
+void wbLauncherDelete(struct wbLauncher *wbl)
+{
+    if (wbl == NULL) {
+        return;
+    }
+
+    for (ULONG i = 0; i < wbl->wl_Slots; i++) {
+        wbLauncherControl(wbl, wbl->wl_Slot[i].wls_Port, &wbl->wl_Slot[i]);
+    }
+
+    DeleteMsgPort(wbl->wl_ReplyPort);
+    FreeVec(wbl);
+}
@@ -0,0 +1,50 @@
+// Copyright 2023, Jason S. McMullan <jason.mcmullan@gmail.com>
+//
+// This code licensed under the MIT License, as follows:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the “Software”), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <proto/exec.h>
+#include <proto/dos.h>
+
+#ifdef __AROS__
+#include "workbook_aros.h"
+#else
+#include "workbook_vbcc.h"
+#endif
+
+// Number of persistent launcher processes.
+// Launches for the same device are always handled by the same process,
+// so at most this many devices are busy opening tools and projects at once.
+#ifndef WBLAUNCHER_PROCESSES
+#define WBLAUNCHER_PROCESSES    2
+#endif
+
+struct wbLauncher;
+
+// Start the launcher processes. Returns NULL if none could be started.
+struct wbLauncher *_wbLauncherCreate(struct Library *_DOSBase);
+#define wbLauncherCreate() _wbLauncherCreate(DOSBase)
+
+// Queue a tool or project for opening with OpenWorkbenchObject().
+// 'dir' is not consumed; 'file' is relative to 'dir'.
+// Returns FALSE if the request could not be queued.
+BOOL _wbLauncherOpen(struct Library *_DOSBase, struct wbLauncher *wbl, BPTR dir, CONST_STRPTR file);
+#define wbLauncherOpen(wbl, dir, file) _wbLauncherOpen(DOSBase, wbl, dir, file)
+
+// Stop the launcher processes, after all queued requests have been handled.
+void wbLauncherDelete(struct wbLauncher *wbl);
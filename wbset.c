@@ -32,19 +32,11 @@
 #endif
 
 
-struct wbSetNode {
-    struct Node sn_Node;
-    Object        *sn_Object;   // Gadget object
-    BOOL           sn_Backdrop;    // Is the backdrop set?
-    LONG           sn_CurrentX;    // do_CurrentX cache.
-    LONG           sn_CurrentY;    // do_CurrentY cache.
-};
-
 #define IS_VISIBLE(node)    ((node)->sn_Backdrop == my->Backdrop)
 #define IS_ARRANGED(node)   ((node)->sn_CurrentX != (LONG)NO_ICON_POSITION) && ((node)->sn_CurrentY != (LONG)NO_ICON_POSITION)
 
 struct wbSet {
-    struct List SetObjects;
+    struct List SetObjects;     // struct wbSetNode, embedded in each member.
     UWORD ViewModes;            // Same a 'DrawerData->dd_ViewModes'
     BOOL  Arranged;
     BOOL  Backdrop;
@@ -84,24 +76,36 @@ static IPTR WBSet__OM_ADDMEMBER(Class *cl, Object *obj, struct opMember *opm)
     Object *iobj = opm->opam_Object;
     struct IBox ibox;
     struct wbSet *my = INST_DATA(cl, obj);
-    struct wbSetNode *node;
+    struct wbSetNode *node = NULL;
 
     IPTR rc = 0;
 
-    node = AllocVec(sizeof(*node), MEMF_ANY);
+    GetAttr(WBIA_SetNode, iobj, (IPTR *)&node);
     if (node) {
         node->sn_Object = iobj;
 
         // Cache some useful info.
         wbSetUpdateNode(cl, obj, node);
 
+        // Only one icon per label.
+        struct wbSetNode *tmp;
+        ForeachNode(&my->SetObjects, tmp) {
+            // Labels interned in the same window compare equal by pointer.
+            if (tmp->sn_Node.ln_Name == node->sn_Node.ln_Name ||
+                Stricmp(tmp->sn_Node.ln_Name, node->sn_Node.ln_Name) == 0) {
+                D(bug("%s: Duplicated icon '%s'\n", __func__, node->sn_Node.ln_Name));
+                return 0;
+            }
+        }
+
         AddTail(&my->SetObjects, &node->sn_Node);
 
         SetAttrs(iobj, WBIA_ListView, my->ViewModes != DDVM_BYICON, TAG_END);
 
         my->Arranged = FALSE;
 
-        rc = DoSuperMethodA(cl, obj, (Msg)opm);
+        DoSuperMethodA(cl, obj, (Msg)opm);
+        rc = TRUE;
     }
 
     return rc;
@@ -109,18 +113,17 @@ static IPTR WBSet__OM_ADDMEMBER(Class *cl, Object *obj, struct opMember *opm)
 
 static IPTR WBSet__OM_REMMEMBER(Class *cl, Object *obj, struct opMember *opm)
 {
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
     Object *iobj = opm->opam_Object;
     struct wbSet *my = INST_DATA(cl, obj);
-    struct wbSetNode *node, *next;
+    struct wbSetNode *node = NULL;
     IPTR rc;
 
     rc = DoSuperMethodA(cl, obj, (Msg)opm);
 
-    ForeachNodeSafe(&my->SetObjects, node, next) {
-        if (node->sn_Object == iobj) {
-            Remove(&node->sn_Node);
-            FreeVec(node);
-        }
+    GetAttr(WBIA_SetNode, iobj, (IPTR *)&node);
+    if (node) {
+        Remove(&node->sn_Node);
     }
 
     my->Arranged = FALSE;
@@ -187,16 +190,33 @@ static IPTR WBSet__OM_SET(Class *cl, Object *obj, struct opSet *ops)
     return DoSuperMethodA(cl, obj, (Msg)ops);
 }
 
+// OM_GET
+static IPTR WBSet__OM_GET(Class *cl, Object *obj, struct opGet *opg)
+{
+    struct wbSet *my = INST_DATA(cl, obj);
+    IPTR rc = TRUE;
+
+    switch (opg->opg_AttrID) {
+    case WBSA_Members:
+        *(opg->opg_Storage) = (IPTR)&my->SetObjects;
+        break;
+    default:
+        rc = DoSuperMethodA(cl, obj, (Msg)opg);
+        break;
+    }
+
+    return rc;
+}
+
 // OM_DISPOSE
 static IPTR WBSet__OM_DISPOSE(Class *cl, Object *obj, Msg msg)
 {
     struct wbSet *my = INST_DATA(cl, obj);
     struct wbSetNode *node, *next;
 
-    /* Remove all the nodes */
+    /* Remove all the nodes. The members are disposed by groupgclass. */
     ForeachNodeSafe(&my->SetObjects, node, next) {
         Remove(&node->sn_Node);
-        FreeVec(node);
     }
 
     return DoSuperMethodA(cl, obj, msg);
@@ -701,6 +721,7 @@ static IPTR WBSet_dispatcher(Class *cl, Object *obj, Msg msg)
     switch (msg->MethodID) {
     METHOD_CASE(WBSet, OM_NEW);
     METHOD_CASE(WBSet, OM_SET);
+    METHOD_CASE(WBSet, OM_GET);
     METHOD_CASE(WBSet, OM_DISPOSE);
     METHOD_CASE(WBSet, OM_ADDMEMBER);
     METHOD_CASE(WBSet, OM_REMMEMBER);
@@ -30,17 +30,14 @@
 #include "wbcurrent.h"
 #include "workbook_intern.h"
 #include "workbook_menu.h"
+#include "wbworker.h"
 #include "classes.h"
 #include "wbcurrent.h"
 
-struct wbWindow_Icon {
-    struct MinNode wbwiNode;
-    Object *wbwiObject;
-};
-
 struct wbWindow {
     STRPTR         Path;
-    BPTR           Lock;
+    BPTR           Lock;        /* Share->wsl_Lock, or BNULL for the root */
+    struct wbSharedLock *Share; /* Drawer lock, referenced by our icons */
     struct Window *Window;
     struct Menu   *Menu;
     Object        *ScrollH;
@@ -49,19 +46,25 @@ struct wbWindow {
     Object        *Set;       /* Set of icons */
 
     ULONG          dd_Flags;
+    BOOL           Hidden;              /* WBWM_Hide, so no icons are in view */
+    BOOL           Shed;                /* WBWM_Shed, so icons may need WBIM_Reload */
     UWORD          dd_ViewModes;        /* Toggled setting */
     UWORD          DefaultViewModes;    /* Parent's view modes */
 
     /* Temporary path buffer */
     TEXT           ScreenTitle[256];
+    BOOL           Status;      // ScreenTitle is showing job status.
     TEXT           WindowTitle[256];
 
     ULONG          AvailChip;
     ULONG          AvailFast;
     ULONG          AvailAny;
 
-    /* List of icons in this window */
-    struct MinList IconList;
+    /* Icons in this window (members of Set), and the pool for their data. */
+    struct List   *Members;
+    APTR           Pool;
+    struct wbStringTable Strings;   /* Icon names, interned in Pool */
+    struct MinList BackdropShares;  /* Root window: drawer locks of left out icons */
 
     // Notify request for this drawer.
     struct {
@@ -79,6 +82,11 @@ static const struct NewMenu WBWindow_menu[] =  {
         WBMENU_ITEM(WBMENU_WB_EXECUTE),
         WBMENU_ITEM(WBMENU_WB_SHELL),
         WBMENU_ITEM(WBMENU_WB_ABOUT),
+        WBMENU_ITEM(WBMENU_WB_CANCEL),
+        WBMENU_SUBTITLE(WBMENU_WB__COPY),
+            WBMENU_SUBITEM(WBMENU_WB__COPY_SYNC),
+            WBMENU_SUBITEM(WBMENU_WB__COPY_VERIFY),
+            WBMENU_SUBITEM(WBMENU_WB__COPY_MOVE),
         WBMENU_BAR,
         WBMENU_ITEM(WBMENU_WB_CUST_UPDATER),
         WBMENU_ITEM(WBMENU_WB_CUST_AMISTORE),
@@ -188,54 +196,49 @@ static BOOL wbFilterFileInfoBlock(struct wbWindow *my, struct FileInfoBlock *fib
     return show_all;
 }
 
-static int wbwiIconCmp(Class *cl, Object *obj, Object *a, Object *b)
+// Add an icon to the window's set.
+// Returns FALSE (and disposes the icon) if it could not be added.
+static BOOL wbwiAppend(Class *cl, Object *obj, Object *iobj)
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbWindow *my = INST_DATA(cl, obj);
 
-    CONST_STRPTR al = NULL, bl = NULL;
-
-    GetAttr(WBIA_Label, a, (IPTR *)&al);
-    GetAttr(WBIA_Label, b, (IPTR *)&bl);
-
-    if (al == bl)
-        return 0;
+    if (!DoMethod(my->Set, OM_ADDMEMBER, (IPTR)iobj)) {
+        D(bug("%s: Unable to add icon to '%s'\n", __func__, my->Path));
+        DisposeObject(iobj);
+        return FALSE;
+    }
 
-    if (al == NULL)
-        return 1;
+    return TRUE;
+}
 
-    if (bl == NULL)
-        return -1;
+// Remove an icon from the window's set, and dispose of it.
+static void wbwiRemove(Class *cl, Object *obj, struct wbSetNode *sn)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbWindow *my = INST_DATA(cl, obj);
+    Object *iobj = sn->sn_Object;
 
-    return Stricmp(al, bl);
+    DoMethod(my->Set, OM_REMMEMBER, (IPTR)iobj);
+    DisposeObject(iobj);
 }
 
-static void wbwiAppend(Class *cl, Object *obj, Object *iobj)
+// Find the icon for a file in this window.
+static struct wbSetNode *wbwiLookup(Class *cl, Object *obj, CONST_STRPTR file)
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
     struct wbWindow *my = INST_DATA(cl, obj);
-    struct wbWindow_Icon *wbwi;
+    struct wbSetNode *sn;
 
-    wbwi = AllocMem(sizeof(*wbwi), MEMF_ANY);
-    if (!wbwi) {
-        DisposeObject(iobj);
-    } else {
-        struct wbWindow_Icon *tmp, *pred = NULL;
-        wbwi->wbwiObject = iobj;
-
-        /* Insert in Alpha order */
-        ForeachNode(&my->IconList, tmp) {
-            if (wbwiIconCmp(cl, obj, tmp->wbwiObject, wbwi->wbwiObject) == 0) {
-                D(bug("%s: Duplicated icon in '%s'\n", __func__, my->Path));
-                DisposeObject(iobj);
-                return;
-            }
-            if (wbwiIconCmp(cl, obj, tmp->wbwiObject, wbwi->wbwiObject) < 0)
-                break;
-            pred = tmp;
+    ForeachNode(my->Members, sn) {
+        CONST_STRPTR sn_file = NULL;
+        GetAttr(WBIA_File, sn->sn_Object, (IPTR *)&sn_file);
+        if (sn_file != NULL && (sn_file == file || Stricmp(sn_file, file) == 0)) {
+            return sn;
         }
-
-        Insert((struct List *)&my->IconList, (struct Node *)wbwi, (struct Node *)pred);
     }
+
+    return NULL;
 }
 
 static void wbAddFiles(Class *cl, Object *obj)
@@ -254,9 +257,11 @@ static void wbAddFiles(Class *cl, Object *obj)
             while (ExNext(my->Lock, fib)) {
                 if (wbFilterFileInfoBlock(my, fib)) {
                     Object *iobj = NewObject(WBIcon, NULL,
-                            WBIA_ParentLock, my->Lock,
+                            WBIA_ParentShare, my->Share,
                             WBIA_File, fib->fib_FileName,
                             WBIA_Screen, my->Window->WScreen,
+                            WBIA_Pool, my->Pool,
+                            WBIA_Strings, &my->Strings,
                             TAG_END);
                     if (iobj != NULL) {
                         wbwiAppend(cl, obj, iobj);
@@ -274,7 +279,147 @@ static void wbAddFiles(Class *cl, Object *obj)
     D(bug("%s: Added!\n", __func__));
 }
 
-static void wbAddVolumeIcons(Class *cl, Object *obj)
+// Lock of a left out icon in the root window, or BNULL (ie for volumes).
+static BPTR wbwiBackdropLock(Class *cl, Object *obj, Object *iobj)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    IPTR parent = (IPTR)BNULL;
+    IPTR lock = (IPTR)BNULL;
+
+    GetAttr(WBIA_ParentLock, iobj, &parent);
+    if ((BPTR)parent != BNULL) {
+        GetAttr(WBIA_BackdropLock, iobj, &lock);
+    }
+
+    return (BPTR)lock;
+}
+
+// An icon already in the root window, found again by a refresh.
+struct wbwiKeep {
+    Object *wk_Object;
+    BPTR    wk_Lock;        // WBIA_BackdropLock
+    ULONG   wk_Key;         // Path key, or volume node for a volume
+    BOOL    wk_Volume;
+    BOOL    wk_Kept;
+};
+
+// The root window's icons, hashed by wk_Key (open addressing).
+struct wbwiKeepTable {
+    struct wbwiKeep *wkt_Slot;
+    ULONG            wkt_Size;   // A power of two, with at least half free.
+};
+
+static inline ULONG wbwiKeepIndex(struct wbwiKeepTable *wkt, ULONG key)
+{
+    return (key ^ (key >> 16)) & (wkt->wkt_Size - 1);
+}
+
+// Hash the root window's icons. Icons that are no longer on the backdrop
+// (ie put away) are disposed of now. If there is no memory for the table,
+// all of them are, and the root window is built from scratch.
+static void wbwiKeepInit(Class *cl, Object *obj, struct wbwiKeepTable *wkt)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbWindow *my = INST_DATA(cl, obj);
+    struct wbSetNode *sn, *next;
+    ULONG count = 0;
+
+    ForeachNode(my->Members, sn) {
+        count++;
+    }
+
+    for (wkt->wkt_Size = 16; wkt->wkt_Size < count * 2; wkt->wkt_Size <<= 1);
+    wkt->wkt_Slot = AllocVec(wkt->wkt_Size * sizeof(struct wbwiKeep), MEMF_ANY | MEMF_CLEAR);
+
+    ForeachNodeSafe(my->Members, sn, next) {
+        Object *iobj = sn->sn_Object;
+        struct wbwiKeep wk = { iobj, BNULL, 0, FALSE, FALSE };
+        IPTR tmp = (IPTR)BNULL;
+
+        GetAttr(WBIA_BackdropLock, iobj, &tmp);
+        wk.wk_Lock = (BPTR)tmp;
+        if (wk.wk_Lock == BNULL || wkt->wkt_Slot == NULL) {
+            wbwiRemove(cl, obj, sn);
+            continue;
+        }
+        if (wbwiBackdropLock(cl, obj, iobj) == BNULL) {
+            struct FileLock *fl = BADDR(wk.wk_Lock);
+            wk.wk_Volume = TRUE;
+            wk.wk_Key = (ULONG)(IPTR)fl->fl_Volume;
+        } else {
+            tmp = 0;
+            GetAttr(WBIA_BackdropKey, iobj, &tmp);
+            wk.wk_Key = (ULONG)tmp;
+        }
+
+        ULONG i = wbwiKeepIndex(wkt, wk.wk_Key);
+        while (wkt->wkt_Slot[i].wk_Object != NULL) {
+            i = (i + 1) & (wkt->wkt_Size - 1);
+        }
+        wkt->wkt_Slot[i] = wk;
+    }
+}
+
+// Find the icon for a volume (by its DosList node and 'VOLUME:' name), or
+// for a backdrop entry (by its path key, confirmed with SameLock()), and
+// keep it.
+static BOOL wbwiKeepFind(Class *cl, Object *obj, struct wbwiKeepTable *wkt, ULONG key, BPTR lock, CONST_STRPTR volume)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+
+    if (wkt->wkt_Slot == NULL) {
+        return FALSE;
+    }
+
+    for (ULONG i = wbwiKeepIndex(wkt, key); wkt->wkt_Slot[i].wk_Object != NULL; i = (i + 1) & (wkt->wkt_Size - 1)) {
+        struct wbwiKeep *wk = &wkt->wkt_Slot[i];
+        if (wk->wk_Kept || wk->wk_Key != key || wk->wk_Volume != (volume != NULL)) {
+            continue;
+        }
+        BOOL same;
+        if (volume != NULL) {
+            // A relabelled volume gets a new icon.
+            CONST_STRPTR file = NULL;
+            GetAttr(WBIA_File, wk->wk_Object, (IPTR *)&file);
+            same = (file != NULL && Stricmp(file, volume) == 0);
+        } else {
+            same = (SameLock(wk->wk_Lock, lock) == LOCK_SAME);
+        }
+        if (same) {
+            wk->wk_Kept = TRUE;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+// Dispose of the icons that were not found again.
+static void wbwiKeepFree(Class *cl, Object *obj, struct wbwiKeepTable *wkt)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+
+    if (wkt->wkt_Slot == NULL) {
+        return;
+    }
+
+    for (ULONG i = 0; i < wkt->wkt_Size; i++) {
+        struct wbwiKeep *wk = &wkt->wkt_Slot[i];
+        if (wk->wk_Object != NULL && !wk->wk_Kept) {
+            struct wbSetNode *sn = NULL;
+            GetAttr(WBIA_SetNode, wk->wk_Object, (IPTR *)&sn);
+            D(bug("%s:   gone   %s\n", __func__, sn->sn_Node.ln_Name));
+            wbwiRemove(cl, obj, sn);
+        }
+    }
+
+    FreeVec(wkt->wkt_Slot);
+    wkt->wkt_Slot = NULL;
+}
+
+// Bring the root window's volume icons up to date. Icons of volumes that
+// are still mounted are kept, along with their WBBackdrop volume.
+static void wbAddVolumeIcons(Class *cl, Object *obj, struct wbwiKeepTable *wkt)
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
     struct wbWindow *my = INST_DATA(cl, obj);
@@ -294,11 +439,17 @@ static void wbAddVolumeIcons(Class *cl, Object *obj)
             CopyMem(AROS_BSTR_ADDR(tdl->dol_Name), text, AROS_BSTR_strlen(tdl->dol_Name));
             CopyMem(":",&text[AROS_BSTR_strlen(tdl->dol_Name)],2);
 
+            if (wbwiKeepFind(cl, obj, wkt, (ULONG)(IPTR)MKBADDR(tdl), BNULL, text)) {
+                continue;
+            }
+
             iobj = NewObject(WBIcon, NULL,
                     WBIA_File, text,
                     WBIA_Label, AROS_BSTR_ADDR(tdl->dol_Name),
                     WBIA_ParentLock, BNULL,
                     WBIA_Screen, my->Window->WScreen,
+                    WBIA_Pool, my->Pool,
+                    WBIA_Strings, &my->Strings,
                     TAG_END);
             D(bug("%s: %s => %p\n", __func__, text, iobj));
             if (iobj) {
@@ -309,39 +460,192 @@ static void wbAddVolumeIcons(Class *cl, Object *obj)
     }
 }
 
-static void wbAddBackdropIcons(Class *cl, Object *obj)
+// A drawer lock held by the root window for its left out icons.
+struct wbwiShare {
+    struct MinNode ws_Node;
+    struct wbSharedLock *ws_Share;  // wsl_Hash is the drawer's key.
+};
+
+// Shared lock of the drawer that a backdrop entry is in. Left out icons
+// from the same drawer share one, so that a drawer is only kept locked
+// once, however many icons are left out of it.
+static struct wbSharedLock *wbwiBackdropShare(Class *cl, Object *obj, struct wbBackdropEntry *wbe, BPTR lock)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbWindow *my = INST_DATA(cl, obj);
+    ULONG key = wbBackdropHashParent(wbe->wbe_Path);
+    struct wbwiShare *ws;
+
+    BPTR parent = ParentDir(lock);
+    if (parent == BNULL) {
+        return NULL;
+    }
+
+    ForeachNode(&my->BackdropShares, ws) {
+        if (ws->ws_Share->wsl_Hash == key && SameLock(ws->ws_Share->wsl_Lock, parent) == LOCK_SAME) {
+            UnLock(parent);
+            return ws->ws_Share;
+        }
+    }
+
+    ws = wbAllocPooled(my->Pool, sizeof(*ws));
+    if (ws != NULL) {
+        ws->ws_Share = wbSharedLockAdopt(wb, parent);
+        if (ws->ws_Share != NULL) {
+            ws->ws_Share->wsl_Hash = key;
+            ws->ws_Share->wsl_Hashed = TRUE;
+            AddTailMinList(&my->BackdropShares, &ws->ws_Node);
+            return ws->ws_Share;
+        }
+        wbFreePooled(my->Pool, ws);
+    }
+
+    UnLock(parent);
+    return NULL;
+}
+
+// Let go of the drawer locks that no icon uses any more (or all of them).
+static void wbwiBackdropSharesRelease(Class *cl, Object *obj, BOOL all)
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
     struct wbWindow *my = INST_DATA(cl, obj);
+    struct wbwiShare *ws, *next;
 
-    BPTR lock = BNULL;
+    ForeachNodeSafe(&my->BackdropShares, ws, next) {
+        if (all || ws->ws_Share->wsl_Count == 1) {
+            RemoveMinNode(&ws->ws_Node);
+            wbSharedLockRelease(wb, ws->ws_Share);
+            wbFreePooled(my->Pool, ws);
+        }
+    }
+}
+
+// Bring the root window's backdrop icons up to date. Icons still on the
+// backdrop are kept as they are; only new entries get an icon built.
+static void wbAddBackdropIcons(Class *cl, Object *obj, struct wbwiKeepTable *wkt)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbWindow *my = INST_DATA(cl, obj);
+    struct wbbm_Cursor cursor = { NULL, NULL, 0 };
+    BPTR lock;
 
     D(bug("%s: Scanning backdrop locks...\n", __func__));
-    while ((lock = DoMethod(wb->wb_Backdrop, WBBM_LockNext, lock)) != BNULL) {
+    while ((lock = (BPTR)DoMethod(wb->wb_Backdrop, WBBM_LockNext, &cursor)) != BNULL) {
         D(bug("%s: lock %lx\n", __func__, (IPTR)lock));
-        BPTR parent = ParentDir(lock);
-        if (parent != BNULL) {
-            D(bug("%s:   parent %lx\n", __func__, (IPTR)parent));
-            STRPTR path = wbAbspathLock(lock);
-            if (path != NULL) {
-                D(bug("%s:   path   %s\n", __func__, path));
-                Object *iobj = NewObject(WBIcon, NULL,
-                        WBIA_File, FilePart(path),
-                        WBIA_Label, FilePart(path),
-                        WBIA_ParentLock, parent,
-                        WBIA_Screen, my->Window->WScreen,
-                        TAG_END);
-                D(bug("%s: %s => %p\n", __func__, path, iobj));
-                if (iobj) {
-                    wbwiAppend(cl, obj, iobj);
-                }
-                FreeVec(path);
+        if (wbwiKeepFind(cl, obj, wkt, cursor.wbbmc_Key, lock, NULL)) {
+            continue;
+        }
+
+        // The entry has its path, so no NameFromLock() is needed.
+        struct wbBackdropEntry *wbe = cursor.wbbmc_Entry;
+        struct wbSharedLock *share = wbwiBackdropShare(cl, obj, wbe, lock);
+        if (share != NULL) {
+            D(bug("%s:   new    %s\n", __func__, wbe->wbe_Path));
+            Object *iobj = NewObject(WBIcon, NULL,
+                    WBIA_File, FilePart(wbe->wbe_Path),
+                    WBIA_ParentShare, share,
+                    WBIA_BackdropKey, wbe->wbe_Key,
+                    WBIA_Screen, my->Window->WScreen,
+                    WBIA_Pool, my->Pool,
+                    WBIA_Strings, &my->Strings,
+                    TAG_END);
+            D(bug("%s: %s => %p\n", __func__, wbe->wbe_Path, iobj));
+            if (iobj) {
+                wbwiAppend(cl, obj, iobj);
             }
-            UnLock(parent);
         }
     }
 }
 
+// Should a file (by FilePart() name, without any .info suffix) be shown in this window?
+// This mirrors wbFilterFileInfoBlock() for a single, already known, name.
+static BOOL wbWindowFileVisible(Class *cl, Object *obj, CONST_STRPTR file)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbWindow *my = INST_DATA(cl, obj);
+
+    ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
+
+    if (stricmp(file, "disk") == 0 || stricmp(file, ".backdrop") == 0) {
+        return FALSE;
+    }
+
+    CONST_STRPTR name = file;
+    TEXT info[FILENAME_MAX];
+    if (!(my->dd_Flags & DDFLAGS_SHOWALL)) {
+        // Only objects with icons are visible.
+        snprintf(info, sizeof(info), "%s.info", file);
+        info[sizeof(info)-1] = 0;
+        name = info;
+    }
+
+    BPTR pwd = CurrentDir(my->Lock);
+    BPTR lock = Lock(name, SHARED_LOCK);
+    CurrentDir(pwd);
+
+    if (lock == BNULL) {
+        return FALSE;
+    }
+
+    UnLock(lock);
+    return TRUE;
+}
+
+// Is the icon gadget within the window's borders?
+static BOOL wbWindowInView(Class *cl, Object *obj, struct Gadget *gadget)
+{
+    struct wbWindow *my = INST_DATA(cl, obj);
+    struct Window *win = my->Window;
+
+    if (my->Hidden) {
+        return FALSE;
+    }
+
+    // Icon gadgets are positioned in window coordinates.
+    WORD minx = win->BorderLeft;
+    WORD miny = win->BorderTop;
+    WORD maxx = win->Width - win->BorderRight - 1;
+    WORD maxy = win->Height - win->BorderBottom - 1;
+
+    return (gadget->LeftEdge <= maxx && gadget->LeftEdge + gadget->Width - 1 >= minx &&
+            gadget->TopEdge <= maxy && gadget->TopEdge + gadget->Height - 1 >= miny);
+}
+
+// Rebuild the imagery of shed icons that are now in view, and draw them.
+// Icons may be drawn on input.device's task, which must not load them,
+// so until then they are left blank.
+static void wbWindowReload(Class *cl, Object *obj)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbWindow *my = INST_DATA(cl, obj);
+    struct wbSetNode *sn;
+    BOOL reloaded = FALSE;
+    BOOL shed = FALSE;
+
+    ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
+
+    if (!my->Shed) {
+        return;
+    }
+
+    ForeachNode(my->Members, sn) {
+        if (!wbWindowInView(cl, obj, (struct Gadget *)sn->sn_Object)) {
+            shed = TRUE;
+            continue;
+        }
+        if (DoMethod(sn->sn_Object, WBIM_Reload)) {
+            reloaded = TRUE;
+        }
+    }
+
+    // Out of view icons may still be shed.
+    my->Shed = shed;
+
+    if (reloaded) {
+        RefreshGadgets(my->Window->FirstGadget, my->Window, NULL);
+    }
+}
+
 static void wbWindowRedimension(Class *cl, Object *obj)
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
@@ -457,6 +761,11 @@ static void wbWindowRefreshView(Class *cl, Object *obj)
 
     /* Adjust the scrolling regions */
     wbWindowRedimension(cl, obj);
+
+    // Icons reloaded for one view may still lack the other's imagery, and
+    // are laid out without it, so load it now for those that are in view.
+    my->Shed = TRUE;
+    wbWindowReload(cl, obj);
 }
 
 /* Rescan the Lock for new entries */
@@ -464,7 +773,6 @@ static IPTR WBWindow__WBWM_CacheContents(Class *cl, Object *obj, Msg msg)
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
     struct wbWindow *my = INST_DATA(cl, obj);
-    struct wbWindow_Icon *wbwi;
 
     if (my->Notify.Cached) {
         return 0;
@@ -474,32 +782,28 @@ static IPTR WBWindow__WBWM_CacheContents(Class *cl, Object *obj, Msg msg)
     D(bug("%s: BUSY....\n", __func__));
     SetWindowPointer(my->Window, WA_BusyPointer, TRUE, TAG_END);
 
-    /* Remove and undisplay any existing icons */
-    struct wbWindow_Icon *tmp;
-    ForeachNodeSafe(&my->IconList, wbwi, tmp) {
-        DoMethod(my->Set, OM_REMMEMBER, wbwi->wbwiObject);
-        DisposeObject(wbwi->wbwiObject);
-        RemoveMinNode(&wbwi->wbwiNode);
-        FreeMem(wbwi, sizeof(*wbwi));
-    }
-
-    /* Scan for new icons, and add them to the list
+    /* Scan for new icons, and add them to the set
      */
     if (my->Lock == BNULL) {
-        /* Root window */
-        wbAddVolumeIcons(cl, obj);
-        wbAddBackdropIcons(cl, obj);
+        /* Root window - icons that are still there are kept, so that
+         * volumes don't reload their .backdrop, and left out icons
+         * aren't rebuilt.
+         */
+        struct wbwiKeepTable wkt;
+        wbwiKeepInit(cl, obj, &wkt);
+        wbAddVolumeIcons(cl, obj, &wkt);
+        wbAddBackdropIcons(cl, obj, &wkt);
+        wbwiKeepFree(cl, obj, &wkt);
+        wbwiBackdropSharesRelease(cl, obj, FALSE);
     } else {
-        /* Directory window */
+        /* Directory window - remove and undisplay any existing icons */
+        struct wbSetNode *sn, *next;
+        ForeachNodeSafe(my->Members, sn, next) {
+            wbwiRemove(cl, obj, sn);
+        }
         wbAddFiles(cl, obj);
     }
 
-    /* Add the new icons */
-    ForeachNode(&my->IconList, wbwi)
-    {
-        DoMethod(my->Set, OM_ADDMEMBER, (IPTR)wbwi->wbwiObject);
-    }
-
     // Refresh the view of the set.
     wbWindowRefreshView(cl, obj);
 
@@ -558,6 +862,88 @@ static IPTR WBWindow__WBWM_CacheContents(Class *cl, Object *obj, Msg msg)
 }
 
 
+// Reload a single icon, instead of rescanning the whole drawer.
+static IPTR WBWindow__WBWM_UpdateFile(Class *cl, Object *obj, struct wbwm_UpdateFile *wbwmu)
+{
+    struct WorkbookBase *wb = (APTR)cl->cl_UserData;
+    struct wbWindow *my = INST_DATA(cl, obj);
+
+    ASSERT_VALID_PROCESS((struct Process *)FindTask(NULL));
+
+    if (!my->Notify.Cached) {
+        // A full rescan is already pending.
+        return 0;
+    }
+
+    if (my->Lock == BNULL) {
+        // The root window's icons are volumes and backdrop icons
+        // from all over the place - just rescan it. Its icons are
+        // kept by a rescan, so drop the one that changed first.
+        struct wbSetNode *old = wbwiLookup(cl, obj, wbwmu->wbwmu_File);
+        if (old != NULL) {
+            wbwiRemove(cl, obj, old);
+        }
+        CoerceMethod(cl, obj, WBWM_InvalidateContents, (IPTR)BNULL);
+        CoerceMethod(cl, obj, WBWM_CacheContents);
+        return 0;
+    }
+
+    // The icon for 'foo.info' is 'foo'.
+    TEXT file[FILENAME_MAX];
+    strncpy(file, wbwmu->wbwmu_File, sizeof(file)-1);
+    file[sizeof(file)-1] = 0;
+    int len = strlen(file);
+    if (len >= 5 && stricmp(&file[len-5], ".info") == 0) {
+        file[len-5] = 0;
+    }
+
+    D(bug("%s: %s: Update '%s'\n", __func__, my->Path, file));
+
+    struct wbSetNode *old = wbwiLookup(cl, obj, file);
+    Object *iobj = NULL;
+    if (wbWindowFileVisible(cl, obj, file)) {
+        iobj = NewObject(WBIcon, NULL,
+                WBIA_ParentShare, my->Share,
+                WBIA_File, file,
+                WBIA_Screen, my->Window->WScreen,
+                WBIA_Pool, my->Pool,
+                WBIA_Strings, &my->Strings,
+                TAG_END);
+        if (iobj == NULL) {
+            BPTR pwd = CurrentDir(my->Lock);
+            BPTR lock = Lock(file, SHARED_LOCK);
+            CurrentDir(pwd);
+            if (lock != BNULL) {
+                // It's there, but we couldn't make an icon for it.
+                // Fall back to rescanning this drawer alone.
+                UnLock(lock);
+                D(bug("%s: %s: Can't reload '%s', rescanning\n", __func__, my->Path, file));
+                CoerceMethod(cl, obj, WBWM_InvalidateContents, (IPTR)BNULL);
+                CoerceMethod(cl, obj, WBWM_CacheContents);
+                return 0;
+            }
+        }
+    }
+
+    if (old == NULL && iobj == NULL) {
+        // Not here before, not here now.
+        return 0;
+    }
+
+    if (old != NULL) {
+        wbwiRemove(cl, obj, old);
+    }
+
+    if (iobj != NULL) {
+        wbwiAppend(cl, obj, iobj);
+    }
+
+    // Refresh the view of the set.
+    wbWindowRefreshView(cl, obj);
+
+    return 0;
+}
+
 static const struct TagItem scrollv2window[] = {
         { PGA_Top, WBVA_VirtTop },
         { TAG_END, 0 },
@@ -751,6 +1137,27 @@ static struct Window *wbWindowNew(Class *cl, Object *obj, BOOL backdrop, struct
     } else {
         item_backdrop->Flags &= ~CHECKED;
     }
+    // Copy options are per application, not per window.
+    IPTR copyflags = 0;
+    if (wb->wb_App) {
+        GetAttr(WBAA_CopyFlags, wb->wb_App, &copyflags);
+    }
+    static const struct {
+        IPTR  id;
+        ULONG flag;
+    } copyoptions[] = {
+        { WBMENU_ID(WBMENU_WB__COPY_SYNC),   WBCOPYF_SYNC },
+        { WBMENU_ID(WBMENU_WB__COPY_VERIFY), WBCOPYF_VERIFY },
+        { WBMENU_ID(WBMENU_WB__COPY_MOVE),   WBCOPYF_MOVE },
+    };
+    for (size_t i = 0; i < sizeof(copyoptions)/sizeof(copyoptions[0]); i++) {
+        struct MenuItem *item = ItemAddress(my->Menu, wbMenuNumber(copyoptions[i].id));
+        if (copyflags & copyoptions[i].flag) {
+            item->Flags |= CHECKED;
+        } else {
+            item->Flags &= ~CHECKED;
+        }
+    }
     ULONG mn_new_drawer = wbMenuNumber(WBMENU_ID(WBMENU_WN_NEW_DRAWER));
     ULONG mn_open_parent = wbMenuNumber(WBMENU_ID(WBMENU_WN_OPEN_PARENT));
     ULONG mn_ic_copy = wbMenuNumber(WBMENU_ID(WBMENU_IC_COPY));
@@ -884,20 +1291,29 @@ static IPTR WBWindow__OM_NEW(Class *cl, Object *obj, struct opSet *ops)
     my = INST_DATA(cl, obj);
 
     my->dd_Flags = DDFLAGS_SHOWDEFAULT;
+    NEWLIST(&my->BackdropShares);
 
-    NEWLIST(&my->IconList);
+    my->Pool = CreatePool(MEMF_ANY, 4096, 1024);
+    if (my->Pool == NULL)
+        goto error;
+    wbStringTableInit(&my->Strings, my->Pool);
 
     BPTR lock = (BPTR)GetTagData(WBWA_Lock, (IPTR)BNULL, ops->ops_AttrList);
     if (lock == BNULL) {
         my->Path = NULL;
     } else {
-        my->Lock = DupLock(lock);
-        if (my->Lock == BNULL)
+        my->Share = wbSharedLockNew(wb, lock);
+        if (my->Share == NULL)
             goto error;
+        my->Lock = my->Share->wsl_Lock;
 
         my->Path = wbAbspathLock(my->Lock);
         if (my->Path == NULL)
             goto error;
+
+        // Our icons' backdrop keys follow from our path.
+        my->Share->wsl_Hash = wbBackdropHashDir(my->Path);
+        my->Share->wsl_Hashed = TRUE;
     }
 
     my->DefaultViewModes = wbWindowParentViewModes(wb, my->Lock);
@@ -913,6 +1329,10 @@ static IPTR WBWindow__OM_NEW(Class *cl, Object *obj, struct opSet *ops)
                 WBSA_ViewModes, (IPTR)viewModes,
                 WBSA_Backdrop, (my->Path == NULL),
                 TAG_END);
+    if (my->Set == NULL)
+        goto error;
+
+    GetAttr(WBSA_Members, my->Set, (IPTR *)&my->Members);
 
     my->Menu = CreateMenusA((struct NewMenu *)WBWindow_menu, NULL);
     if (my->Menu == NULL) {
@@ -997,7 +1417,6 @@ static IPTR WBWindow__OM_DISPOSE(Class *cl, Object *obj, Msg msg)
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
     struct wbWindow *my = INST_DATA(cl, obj);
-    struct wbWindow_Icon *wbwi;
 
     if (my->Notify.Request.nr_stuff.nr_Msg.nr_Port != NULL) {
         EndNotify(&my->Notify.Request);
@@ -1011,26 +1430,29 @@ static IPTR WBWindow__OM_DISPOSE(Class *cl, Object *obj, Msg msg)
         FreeMenus(my->Menu);
     }
 
-    // We won't need our list of icons anymore
-    while ((wbwi = (APTR)GetHead((struct List *)&my->IconList)) != NULL) {
-        DoMethod(my->Set, OM_REMMEMBER, wbwi->wbwiObject);
-        DisposeObject(wbwi->wbwiObject);
-        RemoveMinNode(&wbwi->wbwiNode);
-        FreeMem(wbwi, sizeof(*wbwi));
+    // We won't need our icons anymore
+    if (my->Members) {
+        struct wbSetNode *sn;
+        while ((sn = (APTR)GetHead(my->Members)) != NULL) {
+            wbwiRemove(cl, obj, sn);
+        }
     }
+    wbwiBackdropSharesRelease(cl, obj, TRUE);
 
     // Dispose of our my->Set
     if (my->Set) {
         DisposeObject(my->Set);
     }
 
+    if (my->Pool) {
+        DeletePool(my->Pool);
+    }
+
     if (my->Path) {
         FreeVec(my->Path);
     }
 
-    if (my->Lock != BNULL) {
-        UnLock(my->Lock);
-    }
+    wbSharedLockRelease(wb, my->Share);
 
     return DoSuperMethodA(cl, obj, msg);
 }
@@ -1110,6 +1532,8 @@ static IPTR WBWindow__WBWM_NewSize(Class *cl, Object *obj, Msg msg)
     wbWindowRedimension(cl, obj);
     wbUnclipWindow(wb, win, clip);
 
+    wbWindowReload(cl, obj);
+
     return 0;
 }
 
@@ -1130,6 +1554,9 @@ static IPTR WBWindow__WBWM_Show(Class *cl, Object *obj, Msg msg)
     struct wbWindow *my = INST_DATA(cl, obj);
 
     ActivateWindow(my->Window);
+    my->Hidden = FALSE;
+
+    wbWindowReload(cl, obj);
 
     return 0;
 }
@@ -1140,10 +1567,36 @@ static IPTR WBWindow__WBWM_Hide(Class *cl, Object *obj, Msg msg)
     struct wbWindow *my = INST_DATA(cl, obj);
 
     HideWindow(my->Window);
+    my->Hidden = TRUE;
 
     return 0;
 }
 
+// WBWM_Shed
+static IPTR WBWindow__WBWM_Shed(Class *cl, Object *obj, Msg msg)
+{
+    struct wbWindow *my = INST_DATA(cl, obj);
+    struct wbSetNode *sn;
+    IPTR count = 0;
+
+    ForeachNode(my->Members, sn) {
+        if (wbWindowInView(cl, obj, (struct Gadget *)sn->sn_Object)) {
+            continue;
+        }
+        if (DoMethod(sn->sn_Object, WBIM_Shed)) {
+            count++;
+        }
+    }
+
+    if (count > 0) {
+        my->Shed = TRUE;
+    }
+
+    D(bug("%s: %s: Shed %ld icons\n", __func__, my->Path ? my->Path : (STRPTR)"(root)", count));
+
+    return count;
+}
+
 static IPTR WBWindow__WBWM_Refresh(Class *cl, Object *obj, Msg msg)
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
@@ -1154,6 +1607,8 @@ static IPTR WBWindow__WBWM_Refresh(Class *cl, Object *obj, Msg msg)
     GT_BeginRefresh(win);
     GT_EndRefresh(win, TRUE);
 
+    wbWindowReload(cl, obj);
+
     return 0;
 }
 
@@ -1200,9 +1655,9 @@ static IPTR wbWindowSnapshot(Class *cl, Object *obj, BOOL all)
 
     if (all) {
         // Snapshot all icons.
-        struct wbWindow_Icon *wbwi;
-        ForeachNode(&my->IconList, wbwi) {
-            DoMethod(wbwi->wbwiObject, WBIM_Snapshot);
+        struct wbSetNode *sn;
+        ForeachNode(my->Members, sn) {
+            DoMethod(sn->sn_Object, WBIM_Snapshot);
         }
     }
 
@@ -1214,7 +1669,7 @@ static IPTR WBWindow__WBWM_ForSelected(Class *cl, Object *obj, struct wbwm_ForSe
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
     struct wbWindow *my = INST_DATA(cl, obj);
-    struct wbWindow_Icon *wbwi;
+    struct wbSetNode *sn;
     IPTR count = 0;
     BOOL update = FALSE;
     BOOL refresh= FALSE;
@@ -1227,24 +1682,24 @@ static IPTR WBWindow__WBWM_ForSelected(Class *cl, Object *obj, struct wbwm_ForSe
     if (modifier) {
         SetWindowPointer(my->Window, WA_BusyPointer, TRUE, WA_PointerDelay, TRUE, TAG_END);
     }
-    ForeachNode(&my->IconList, wbwi) {
+    ForeachNode(my->Members, sn) {
         IPTR selected = FALSE;
-        GetAttr(GA_Selected, wbwi->wbwiObject, &selected);
+        GetAttr(GA_Selected, sn->sn_Object, &selected);
         if (selected) {
             IPTR rc;
             if (wbwmf->wbwmf_Msg->MethodID == WBIM_DragDropAdd) {
-                rc = DoGadgetMethodA((struct Gadget *)wbwi->wbwiObject, my->Window, NULL, wbwmf->wbwmf_Msg);
+                rc = DoGadgetMethodA((struct Gadget *)sn->sn_Object, my->Window, NULL, wbwmf->wbwmf_Msg);
             } else {
-                rc = DoMethodA(wbwi->wbwiObject, wbwmf->wbwmf_Msg);
+                rc = DoMethodA(sn->sn_Object, wbwmf->wbwmf_Msg);
             }
             if (modifier) {
                 update |= (rc & WBIF_UPDATE) == WBIF_UPDATE;
                 refresh|= (rc & WBIF_REFRESH) == WBIF_REFRESH;
             }
-            GetAttr(GA_Selected, wbwi->wbwiObject, &selected);
+            GetAttr(GA_Selected, sn->sn_Object, &selected);
             if (!selected) {
                 // Refresh the gadget.
-                RefreshGList((struct Gadget *)wbwi->wbwiObject, my->Window, NULL, 1);
+                RefreshGList((struct Gadget *)sn->sn_Object, my->Window, NULL, 1);
             }
             count += 1;
         }
@@ -1275,13 +1730,13 @@ static IPTR WBWindow__WBWM_ReportSelected(Class *cl, Object *obj, struct wbwm_Re
 {
     struct WorkbookBase *wb = (APTR)cl->cl_UserData;
     struct wbWindow *my = INST_DATA(cl, obj);
-    struct wbWindow_Icon *wbwi;
+    struct wbSetNode *sn;
 
     ULONG count = 0;
 
-    ForeachNode(&my->IconList, wbwi) {
+    ForeachNode(my->Members, sn) {
         IPTR selected = FALSE;
-        GetAttr(GA_Selected, wbwi->wbwiObject, &selected);
+        GetAttr(GA_Selected, sn->sn_Object, &selected);
         if (selected) {
             count++;
         }
@@ -1309,12 +1764,12 @@ static IPTR WBWindow__WBWM_ReportSelected(Class *cl, Object *obj, struct wbwm_Re
     ULONG index = 0;
     if (count > 0) {
         ti[index++] = (struct TagItem){ WBOPENA_ArgLock, (IPTR)my->Lock };
-        ForeachNode(&my->IconList, wbwi) {
+        ForeachNode(my->Members, sn) {
             IPTR selected = FALSE;
-            GetAttr(GA_Selected, wbwi->wbwiObject, &selected);
+            GetAttr(GA_Selected, sn->sn_Object, &selected);
             if (selected) {
                 CONST_STRPTR file;
-                GetAttr(WBIA_File, wbwi->wbwiObject, (IPTR *)&file);
+                GetAttr(WBIA_File, sn->sn_Object, (IPTR *)&file);
                 ti[index++] = (struct TagItem){ WBOPENA_ArgName, (IPTR)file };
             }
         }
@@ -1381,12 +1836,10 @@ static IPTR WBWindow__WBWM_MenuPick(Class *cl, Object *obj, struct wbwm_MenuPick
     case WBMENU_ID(WBMENU_WN_OPEN_PARENT):
         if (my->Lock != BNULL) {
             lock = ParentDir(my->Lock);
-            STRPTR path = wbAbspathLock(lock);
-            if (path != NULL) {
-                OpenWorkbenchObject(path, TAG_END);
-                FreeVec(path);
+            if (lock != BNULL) {
+                DoMethod(wb->wb_App, WBAM_OpenDrawer, lock);
+                UnLock(lock);
             }
-            UnLock(lock);
         }
         rc = 0;
         break;
@@ -1498,25 +1951,49 @@ static IPTR WBWindow__WBWM_IntuiTick(Class *cl, Object *obj, Msg msg)
         changed = TRUE;
     }
 
+    // Background jobs replace the memory information.
+    IPTR status = (IPTR)NULL;
+    GetAttr(WBAA_Status, wb->wb_App, &status);
+    if (status != (IPTR)NULL || my->Status) {
+        changed = TRUE;
+    }
+
     if (changed) {
+        TEXT title[sizeof(my->ScreenTitle)];
+
         /* Update the window's title */
-        snprintf(my->ScreenTitle, sizeof(my->ScreenTitle),
-                 "%s %d.%d  Chip: %uk, Fast: %uk, Any: %uk",
-            AS_STRING(WB_NAME),
-            WB_VERSION,
-            WB_REVISION,
-            (unsigned)my->AvailChip,
-            (unsigned)my->AvailFast,
-            (unsigned)my->AvailAny);
-        my->ScreenTitle[sizeof(my->ScreenTitle)-1] = 0;
+        if (status != (IPTR)NULL) {
+            snprintf(title, sizeof(title), "%s %d.%d  %s",
+                AS_STRING(WB_NAME),
+                WB_VERSION,
+                WB_REVISION,
+                (CONST_STRPTR)status);
+        } else {
+            snprintf(title, sizeof(title),
+                     "%s %d.%d  Chip: %uk, Fast: %uk, Any: %uk",
+                AS_STRING(WB_NAME),
+                WB_VERSION,
+                WB_REVISION,
+                (unsigned)my->AvailChip,
+                (unsigned)my->AvailFast,
+                (unsigned)my->AvailAny);
+        }
+        title[sizeof(title)-1] = 0;
+        my->Status = (status != (IPTR)NULL);
 
-        SetWindowTitles(my->Window, (CONST_STRPTR)-1, my->ScreenTitle);
-        rc = TRUE;
+        if (strcmp(title, my->ScreenTitle) != 0) {
+            strcpy(my->ScreenTitle, title);
+            SetWindowTitles(my->Window, (CONST_STRPTR)-1, my->ScreenTitle);
+            rc = TRUE;
+        }
     }
 
     // Fake notifications
     CoerceMethod(cl, obj, WBWM_CacheContents);
 
+    // Scrolling may have brought shed icons into view.
+    wbWindowReload(cl, obj);
+
     return rc;
 }
 
@@ -1533,10 +2010,14 @@ static BOOL wbWindowDragDropAccept(Class *cl, Object *obj, LONG targetX, LONG ta
         return FALSE;
     }
 
-    BPTR oldLock = CurrentDir(my->Lock);
-    BOOL ok = wbDropOntoCurrentAt(args, targetX, targetY);
-    LONG err = IoErr();
-    CurrentDir(oldLock);
+    LONG err = 0;
+    BOOL ok = DoMethod(wb->wb_App, WBAM_QueueJob, WBJOB_DROP, my->Lock, NULL, args, targetX, targetY);
+    if (!ok) {
+        BPTR oldLock = CurrentDir(my->Lock);
+        ok = wbDropOntoCurrentAt(args, targetX, targetY, NULL, NULL);
+        err = IoErr();
+        CurrentDir(oldLock);
+    }
 
     FreeTagItems(args);
 
@@ -1633,6 +2114,8 @@ static IPTR WBWindow_dispatcher(Class *cl, Object *obj, Msg msg)
     METHOD_CASE(WBWindow, WBWM_InvalidateContents);
     METHOD_CASE(WBWindow, WBWM_CacheContents);
     METHOD_CASE(WBWindow, WBWM_ReportSelected);
+    METHOD_CASE(WBWindow, WBWM_UpdateFile);
+    METHOD_CASE(WBWindow, WBWM_Shed);
     METHOD_CASE(WBWindow, WBxM_DragDropped);
     default:             rc = DoSuperMethodA(cl, obj, msg); break;
     }
@@ -0,0 +1,676 @@
+// Copyright 2023, Jason S. McMullan <jason.mcmullan@gmail.com>
+//
+// This code licensed under the MIT License, as follows:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the “Software”), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include <string.h>
+
+#include <proto/dos.h>
+#include <proto/exec.h>
+#include <proto/icon.h>
+#include <proto/utility.h>
+
+#include <dos/dosextens.h>
+#include <dos/dostags.h>
+#include <workbench/workbench.h>
+
+#include "wbcurrent.h"
+#include "wbworker.h"
+
+extern struct ExecBase *SysBase;
+
+// Private job types, used to control the runners.
+#define WBJOB_QUIT  ((ULONG)~0)
+#define WBJOB_FLUSH ((ULONG)~1)
+
+// Number of processes running jobs.
+#define WBWORKER_RUNNERS    4
+
+// A process that runs one job at a time.
+struct wbRunner {
+    struct MsgPort *wr_Port;        // Owned by the runner process.
+    struct wbBumpCache *wr_Bump;    // The worker's, shared by all runners.
+    struct wbJob   *wr_Job;         // Job being run, or NULL.
+    BOOL            wr_Dirty;       // Has state to flush once all jobs are done.
+    BOOL            wr_Flushing;    // wr_Flush is with the runner.
+    struct wbJob    wr_Flush;
+    struct wbJob    wr_Quit;
+};
+
+struct wbWorker {
+    struct MsgPort *ww_Port;        // Job queue, owned by the scheduler process.
+    struct MsgPort *ww_JobPort;     // Finished jobs are replied here.
+    struct MsgPort *ww_ReplyPort;   // For startup and shutdown messages.
+    ULONG           ww_PerDevice;   // Jobs allowed to run at once on each device.
+    struct wbBumpCache ww_Bump;     // 'Copy_N_of_' names, shared so that runners
+                                    // copying into the same drawer never pick the same one.
+};
+
+struct wbWorkerStartup {
+    struct Message  wws_Message;
+    APTR            wws_Data;       // struct wbWorker *, or struct wbRunner *
+};
+
+AROS_PROCP(wbWorker);
+AROS_PROCP(wbWorkerRunner);
+
+// Run a single job, with CurrentDir() set to the job's directory.
+static void wbWorkerRun(struct Library *DOSBase, struct Library *IconBase, struct Library *UtilityBase, struct wbBumpCache *bump, struct wbJob *job)
+{
+    struct wbProgress *progress = &job->wj_Progress;
+    BOOL ok = FALSE;
+
+    DateStamp(&job->wj_Start);
+    job->wj_Active = TRUE;
+
+    if (progress->wp_Cancel) {
+        // Cancelled while still in the queue.
+        job->wj_Ok = FALSE;
+        job->wj_Error = ERROR_BREAK;
+        return;
+    }
+
+    BPTR pwd = CurrentDir(job->wj_Dir);
+    switch (job->wj_Type) {
+    case WBJOB_COPY:
+        ok = wbCopyBumpCurrent(job->wj_File, bump, progress);
+        break;
+    case WBJOB_DELETE:
+        ok = wbDeleteFromCurrent(job->wj_File, FALSE, progress);
+        break;
+    case WBJOB_DROP:
+        ok = wbDropOntoCurrentAt(job->wj_Args, job->wj_TargetX, job->wj_TargetY, job->wj_Errors, progress);
+        break;
+    default:
+        SetIoErr(ERROR_ACTION_NOT_KNOWN);
+        break;
+    }
+    job->wj_Error = ok ? 0 : IoErr();
+    job->wj_Ok = ok;
+    CurrentDir(pwd);
+
+    D(bug("%s: Job %lx (type %ld) done: %s (%ld)\n", __func__, (IPTR)job, (IPTR)job->wj_Type, ok ? "TRUE" : "FALSE", (IPTR)job->wj_Error));
+}
+
+// Runner process.
+//
+// As with the launcher, the startup message arrives on pr_MsgPort and tells us
+// where to publish our job port; DOS packet I/O keeps pr_MsgPort for itself.
+AROS_PROCH(wbWorkerRunner, argstr, argsize, SysBase)
+{
+    AROS_PROCFUNC_INIT
+
+    struct Process *proc = (struct Process *)FindTask(NULL);
+    struct wbWorkerStartup *startup;
+    struct wbRunner *wr;
+    struct wbJob *quit = NULL;
+    struct MsgPort *port;
+
+    WaitPort(&proc->pr_MsgPort);
+    startup = (struct wbWorkerStartup *)GetMsg(&proc->pr_MsgPort);
+    wr = startup->wws_Data;
+
+    APTR DOSBase = OpenLibrary("dos.library", 0);
+    APTR IconBase = OpenLibrary("icon.library", 44);
+    APTR UtilityBase = OpenLibrary("utility.library", 0);
+    port = CreateMsgPort();
+
+    if (DOSBase == NULL || IconBase == NULL || UtilityBase == NULL || port == NULL) {
+        if (port)
+            DeleteMsgPort(port);
+        if (UtilityBase)
+            CloseLibrary(UtilityBase);
+        if (IconBase)
+            CloseLibrary(IconBase);
+        if (DOSBase)
+            CloseLibrary(DOSBase);
+        wr->wr_Port = NULL;
+        Forbid();
+        ReplyMsg(&startup->wws_Message);
+        return 0;
+    }
+
+    wr->wr_Port = port;
+    ReplyMsg(&startup->wws_Message);
+
+    while (quit == NULL) {
+        struct wbJob *job;
+
+        WaitPort(port);
+        while ((job = (struct wbJob *)GetMsg(port)) != NULL) {
+            switch (job->wj_Type) {
+            case WBJOB_QUIT:
+                quit = job;
+                break;
+            case WBJOB_FLUSH:
+                // All the queued jobs are done, so forget the copy names.
+                // The directory may change before the next batch.
+                wbBumpCacheFree(wr->wr_Bump);
+                ReplyMsg(&job->wj_Message);
+                break;
+            default:
+                wbWorkerRun(DOSBase, IconBase, UtilityBase, wr->wr_Bump, job);
+                ReplyMsg(&job->wj_Message);
+                break;
+            }
+        }
+    }
+
+    DeleteMsgPort(port);
+    CloseLibrary(UtilityBase);
+    CloseLibrary(IconBase);
+    CloseLibrary(DOSBase);
+
+    // Don't let our caller unload us before we have exited.
+    Forbid();
+    ReplyMsg(&quit->wj_Message);
+
+    return 0;
+
+    AROS_PROCFUNC_EXIT
+}
+
+// The filesystem handler of a lock, which stands in for its device.
+static APTR wbWorkerDevice(BPTR lock)
+{
+    struct FileLock *fl = BADDR(lock);
+
+    return (fl != NULL) ? (APTR)fl->fl_Task : NULL;
+}
+
+// Note a device used by a job, once.
+static void wbJobAddDevice(struct wbJob *job, APTR device)
+{
+    if (device == NULL) {
+        return;
+    }
+
+    for (ULONG i = 0; i < job->wj_DeviceCount; i++) {
+        if (job->wj_Device[i] == device) {
+            return;
+        }
+    }
+
+    if (job->wj_DeviceCount == WBJOB_DEVICES) {
+        // Can't be scheduled per device.
+        job->wj_AnyDevice = TRUE;
+        return;
+    }
+
+    job->wj_Device[job->wj_DeviceCount++] = device;
+}
+
+// Work out which devices a job will use: its directory, and the source drawers of a drop.
+static void wbJobDevices(struct Library *UtilityBase, struct wbJob *job)
+{
+    job->wj_DeviceCount = 0;
+    job->wj_AnyDevice = FALSE;
+    wbJobAddDevice(job, wbWorkerDevice(job->wj_Dir));
+
+    if (job->wj_Args != NULL) {
+        struct TagItem *tstate = job->wj_Args;
+        struct TagItem *ti;
+        while ((ti = NextTagItem(&tstate)) != NULL) {
+            if (ti->ti_Tag == WBOPENA_ArgLock) {
+                wbJobAddDevice(job, wbWorkerDevice((BPTR)ti->ti_Data));
+            }
+        }
+    }
+}
+
+static BOOL wbDeviceIn(APTR device, APTR *devices, ULONG count)
+{
+    for (ULONG i = 0; i < count; i++) {
+        if (devices[i] == device) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+// Start as many pending jobs as the runners and device limits allow.
+//
+// Jobs are started in order. A job that has to wait also holds back any
+// later job on the same devices, so each device sees its jobs in order.
+// A job on too many devices to track (wj_AnyDevice) waits for every
+// earlier job, and holds back every later one.
+static void wbWorkerDispatch(struct wbWorker *wbw, struct wbRunner *runners, ULONG count, struct List *pending, struct MsgPort *done)
+{
+    APTR blocked[WBWORKER_RUNNERS * WBJOB_DEVICES];
+    ULONG blocked_count = 0;
+    struct Node *node, *next;
+
+    ForeachNodeSafe(pending, node, next) {
+        struct wbJob *job = (struct wbJob *)node;
+        struct wbRunner *idle = NULL;
+        BOOL ready = TRUE;
+        BOOL running = FALSE;
+
+        for (ULONG i = 0; i < count; i++) {
+            if (runners[i].wr_Job != NULL) {
+                if (runners[i].wr_Job->wj_AnyDevice) {
+                    // Nothing runs alongside it.
+                    return;
+                }
+                running = TRUE;
+            } else if (idle == NULL && !runners[i].wr_Flushing) {
+                idle = &runners[i];
+            }
+        }
+        if (idle == NULL) {
+            break;
+        }
+
+        if (job->wj_AnyDevice) {
+            if (running || blocked_count > 0) {
+                // Wait for the jobs before it, and keep the ones after it waiting.
+                break;
+            }
+        }
+
+        for (ULONG d = 0; ready && !job->wj_AnyDevice && d < job->wj_DeviceCount; d++) {
+            APTR device = job->wj_Device[d];
+            ULONG active = 0;
+
+            if (wbDeviceIn(device, blocked, blocked_count)) {
+                ready = FALSE;
+                break;
+            }
+
+            for (ULONG i = 0; i < count; i++) {
+                struct wbJob *running = runners[i].wr_Job;
+                if (running != NULL && wbDeviceIn(device, running->wj_Device, running->wj_DeviceCount)) {
+                    active++;
+                }
+            }
+            ready = (active < wbw->ww_PerDevice);
+        }
+
+        if (!ready) {
+            for (ULONG d = 0; d < job->wj_DeviceCount; d++) {
+                if (wbDeviceIn(job->wj_Device[d], blocked, blocked_count)) {
+                    continue;
+                }
+                if (blocked_count == sizeof(blocked)/sizeof(blocked[0])) {
+                    // Can't hold back any more devices, so hold back everything.
+                    return;
+                }
+                blocked[blocked_count++] = job->wj_Device[d];
+            }
+            continue;
+        }
+
+        REMOVE(node);
+        idle->wr_Job = job;
+        idle->wr_Dirty = TRUE;
+        job->wj_Message.mn_ReplyPort = done;
+        PutMsg(idle->wr_Port, &job->wj_Message);
+    }
+}
+
+// Worker (scheduler) process.
+//
+// Queued jobs wait here until a runner is free, and until their devices are
+// below the per-device limit. Jobs on different devices run side by side.
+AROS_PROCH(wbWorker, argstr, argsize, SysBase)
+{
+    AROS_PROCFUNC_INIT
+
+    struct Process *proc = (struct Process *)FindTask(NULL);
+    struct wbWorkerStartup *startup;
+    struct wbWorker *wbw;
+    struct wbRunner runners[WBWORKER_RUNNERS];
+    ULONG count = 0;
+    struct wbJob *quit = NULL;
+    struct MsgPort *port, *done;
+    struct List pending;
+
+    WaitPort(&proc->pr_MsgPort);
+    startup = (struct wbWorkerStartup *)GetMsg(&proc->pr_MsgPort);
+    wbw = startup->wws_Data;
+
+    APTR DOSBase = OpenLibrary("dos.library", 0);
+    APTR UtilityBase = OpenLibrary("utility.library", 0);
+    port = CreateMsgPort();
+    done = CreateMsgPort();
+
+    memset(runners, 0, sizeof(runners));
+    wbBumpCacheInit(&wbw->ww_Bump);
+
+    if (DOSBase != NULL && UtilityBase != NULL && port != NULL && done != NULL) {
+        struct wbWorkerStartup rs;
+
+        // Start the runners. Run just below the Workbench process,
+        // so that the desktop stays responsive.
+        for (ULONG i = 0; i < WBWORKER_RUNNERS; i++) {
+            struct Process *runner = CreateNewProcTags(
+                    NP_Name, (IPTR)"Workbook Worker",
+                    NP_Entry, (IPTR)wbWorkerRunner,
+                    NP_Priority, (IPTR)-1,
+                    TAG_END);
+            if (runner == NULL) {
+                break;
+            }
+
+            memset(&rs, 0, sizeof(rs));
+            rs.wws_Message.mn_Node.ln_Type = NT_MESSAGE;
+            rs.wws_Message.mn_ReplyPort = done;
+            rs.wws_Message.mn_Length = sizeof(rs);
+            rs.wws_Data = &runners[count];
+            runners[count].wr_Bump = &wbw->ww_Bump;
+
+            PutMsg(&runner->pr_MsgPort, &rs.wws_Message);
+            WaitPort(done);
+            GetMsg(done);
+
+            if (runners[count].wr_Port == NULL) {
+                break;
+            }
+            count++;
+        }
+    }
+
+    if (count == 0) {
+        if (done)
+            DeleteMsgPort(done);
+        if (port)
+            DeleteMsgPort(port);
+        if (UtilityBase)
+            CloseLibrary(UtilityBase);
+        if (DOSBase)
+            CloseLibrary(DOSBase);
+        wbw->ww_Port = NULL;
+        Forbid();
+        ReplyMsg(&startup->wws_Message);
+        return 0;
+    }
+
+    for (ULONG i = 0; i < count; i++) {
+        struct wbRunner *wr = &runners[i];
+        wr->wr_Flush.wj_Message.mn_Node.ln_Type = NT_MESSAGE;
+        wr->wr_Flush.wj_Message.mn_ReplyPort = done;
+        wr->wr_Flush.wj_Message.mn_Length = sizeof(wr->wr_Flush);
+        wr->wr_Flush.wj_Type = WBJOB_FLUSH;
+        wr->wr_Quit = wr->wr_Flush;
+        wr->wr_Quit.wj_Type = WBJOB_QUIT;
+    }
+
+    NEWLIST(&pending);
+
+    wbw->ww_Port = port;
+    ReplyMsg(&startup->wws_Message);
+
+    for (;;) {
+        struct wbJob *job;
+        BOOL busy = FALSE;
+
+        // Finished jobs go back to their owner.
+        while ((job = (struct wbJob *)GetMsg(done)) != NULL) {
+            for (ULONG i = 0; i < count; i++) {
+                if (&runners[i].wr_Flush == job) {
+                    runners[i].wr_Flushing = FALSE;
+                } else if (runners[i].wr_Job == job) {
+                    runners[i].wr_Job = NULL;
+                }
+            }
+            if (job->wj_Type != WBJOB_FLUSH) {
+                job->wj_Message.mn_ReplyPort = wbw->ww_JobPort;
+                ReplyMsg(&job->wj_Message);
+            }
+        }
+
+        while ((job = (struct wbJob *)GetMsg(port)) != NULL) {
+            if (job->wj_Type == WBJOB_QUIT) {
+                quit = job;
+                continue;
+            }
+            wbJobDevices(UtilityBase, job);
+            AddTail(&pending, &job->wj_Message.mn_Node);
+        }
+
+        wbWorkerDispatch(wbw, runners, count, &pending, done);
+
+        for (ULONG i = 0; i < count; i++) {
+            busy |= (runners[i].wr_Job != NULL || runners[i].wr_Flushing);
+        }
+        busy |= (GetHead(&pending) != NULL);
+
+        if (!busy) {
+            if (quit != NULL) {
+                break;
+            }
+
+            // Everything is done, so let the runners drop what they were holding on to.
+            for (ULONG i = 0; i < count; i++) {
+                if (runners[i].wr_Dirty) {
+                    runners[i].wr_Dirty = FALSE;
+                    runners[i].wr_Flushing = TRUE;
+                    PutMsg(runners[i].wr_Port, &runners[i].wr_Flush.wj_Message);
+                }
+            }
+        }
+
+        Wait((1UL << port->mp_SigBit) | (1UL << done->mp_SigBit));
+    }
+
+    // Stop the runners.
+    for (ULONG i = 0; i < count; i++) {
+        PutMsg(runners[i].wr_Port, &runners[i].wr_Quit.wj_Message);
+        WaitPort(done);
+        GetMsg(done);
+    }
+
+    wbBumpCacheFree(&wbw->ww_Bump);
+
+    DeleteMsgPort(done);
+    DeleteMsgPort(port);
+    CloseLibrary(UtilityBase);
+    CloseLibrary(DOSBase);
+
+    // Don't let our caller unload us before we have exited.
+    Forbid();
+    ReplyMsg(&quit->wj_Message);
+
+    return 0;
+
+    AROS_PROCFUNC_EXIT
+}
+
+struct wbWorker *_wbWorkerCreate(struct Library *DOSBase, struct MsgPort *port)
+{
+    struct wbWorker *wbw;
+
+    wbw = AllocVec(sizeof(*wbw), MEMF_ANY | MEMF_CLEAR);
+    if (wbw == NULL) {
+        return NULL;
+    }
+
+    // How many jobs may run at once on each device. One keeps
+    // floppies and single spindles from thrashing.
+    TEXT value[16];
+    LONG per_device = 1;
+    if (GetVar("Workbook/JobsPerDevice", value, sizeof(value), 0) > 0) {
+        StrToLong(value, &per_device);
+    }
+    if (per_device < 1) {
+        per_device = 1;
+    } else if (per_device > WBWORKER_RUNNERS) {
+        per_device = WBWORKER_RUNNERS;
+    }
+    wbw->ww_PerDevice = per_device;
+
+    wbw->ww_JobPort = port;
+    wbw->ww_ReplyPort = CreateMsgPort();
+    if (wbw->ww_ReplyPort == NULL) {
+        FreeVec(wbw);
+        return NULL;
+    }
+
+    struct Process *proc = CreateNewProcTags(
+            NP_Name, (IPTR)"Workbook Scheduler",
+            NP_Entry, (IPTR)wbWorker,
+            TAG_END);
+    if (proc != NULL) {
+        struct wbWorkerStartup startup;
+
+        memset(&startup, 0, sizeof(startup));
+        startup.wws_Message.mn_Node.ln_Type = NT_MESSAGE;
+        startup.wws_Message.mn_ReplyPort = wbw->ww_ReplyPort;
+        startup.wws_Message.mn_Length = sizeof(startup);
+        startup.wws_Data = wbw;
+
+        PutMsg(&proc->pr_MsgPort, &startup.wws_Message);
+        WaitPort(wbw->ww_ReplyPort);
+        GetMsg(wbw->ww_ReplyPort);
+    }
+
+    if (wbw->ww_Port == NULL) {
+        DeleteMsgPort(wbw->ww_ReplyPort);
+        FreeVec(wbw);
+        return NULL;
+    }
+
+    return wbw;
+}
+
+void wbWorkerDelete(struct wbWorker *wbw)
+{
+    struct wbJob quit;
+
+    if (wbw == NULL) {
+        return;
+    }
+
+    memset(&quit, 0, sizeof(quit));
+    quit.wj_Message.mn_Node.ln_Type = NT_MESSAGE;
+    quit.wj_Message.mn_ReplyPort = wbw->ww_ReplyPort;
+    quit.wj_Message.mn_Length = sizeof(quit);
+    quit.wj_Type = WBJOB_QUIT;
+
+    PutMsg(wbw->ww_Port, &quit.wj_Message);
+    WaitPort(wbw->ww_ReplyPort);
+    GetMsg(wbw->ww_ReplyPort);
+
+    DeleteMsgPort(wbw->ww_ReplyPort);
+    FreeVec(wbw);
+}
+
+void wbWorkerQueue(struct wbWorker *wbw, struct wbJob *job)
+{
+    job->wj_Message.mn_Node.ln_Type = NT_MESSAGE;
+    job->wj_Message.mn_ReplyPort = wbw->ww_JobPort;
+    job->wj_Message.mn_Length = sizeof(*job);
+
+    PutMsg(wbw->ww_Port, &job->wj_Message);
+}
+
+struct wbJob *_wbJobNew(struct Library *DOSBase, struct Library *UtilityBase, ULONG type, BPTR dir, CONST_STRPTR file, struct TagItem *args, LONG targetX, LONG targetY)
+{
+    struct wbJob *job;
+    BOOL ok = TRUE;
+
+    // Jobs always run in a real directory.
+    if (dir == BNULL) {
+        return NULL;
+    }
+
+    job = AllocVec(sizeof(*job), MEMF_PUBLIC | MEMF_CLEAR);
+    if (job == NULL) {
+        return NULL;
+    }
+
+    job->wj_Type = type;
+    job->wj_TargetX = targetX;
+    job->wj_TargetY = targetY;
+
+    job->wj_Dir = DupLock(dir);
+    if (job->wj_Dir == BNULL) {
+        ok = FALSE;
+    }
+
+    if (ok && file != NULL) {
+        job->wj_File = StrDup(file);
+        ok = (job->wj_File != NULL);
+    }
+
+    if (ok && args != NULL) {
+        job->wj_Args = CloneTagItems(args);
+        ok = (job->wj_Args != NULL);
+        if (ok) {
+            // Take our own copies of the locks and names, as the windows
+            // that reported them may be gone by the time the job runs.
+            struct TagItem *tstate = job->wj_Args;
+            struct TagItem *ti;
+            ULONG names = 0;
+            while ((ti = NextTagItem(&tstate)) != NULL) {
+                switch (ti->ti_Tag) {
+                case WBOPENA_ArgLock:
+                    if ((BPTR)ti->ti_Data != BNULL) {
+                        ti->ti_Data = (IPTR)DupLock((BPTR)ti->ti_Data);
+                        ok &= ((BPTR)ti->ti_Data != BNULL);
+                    }
+                    break;
+                case WBOPENA_ArgName:
+                    ti->ti_Data = (IPTR)StrDup((CONST_STRPTR)ti->ti_Data);
+                    ok &= ((CONST_STRPTR)ti->ti_Data != NULL);
+                    names++;
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            if (ok && names > 0) {
+                job->wj_Errors = AllocVec(sizeof(LONG) * names, MEMF_ANY | MEMF_CLEAR);
+                ok = (job->wj_Errors != NULL);
+            }
+        }
+    }
+
+    if (!ok) {
+        _wbJobFree(DOSBase, UtilityBase, job);
+        return NULL;
+    }
+
+    return job;
+}
+
+void _wbJobFree(struct Library *DOSBase, struct Library *UtilityBase, struct wbJob *job)
+{
+    if (job->wj_Args != NULL) {
+        struct TagItem *tstate = job->wj_Args;
+        struct TagItem *ti;
+        while ((ti = NextTagItem(&tstate)) != NULL) {
+            switch (ti->ti_Tag) {
+            case WBOPENA_ArgLock:
+                UnLock((BPTR)ti->ti_Data);
+                break;
+            case WBOPENA_ArgName:
+                FreeVec((APTR)ti->ti_Data);
+                break;
+            default:
+                break;
+            }
+        }
+        FreeTagItems(job->wj_Args);
+    }
+
+    FreeVec(job->wj_Errors);
+    FreeVec(job->wj_File);
+    UnLock(job->wj_Dir);
+    FreeVec(job);
+}
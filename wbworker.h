@@ -0,0 +1,86 @@
+// Copyright 2023, Jason S. McMullan <jason.mcmullan@gmail.com>
+//
+// This code licensed under the MIT License, as follows:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the “Software”), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <proto/exec.h>
+#include <proto/dos.h>
+
+#include <utility/tagitem.h>
+
+#include "wbcurrent.h"
+
+// Background file operations.
+enum wbJobType {
+    WBJOB_COPY,         // Bump-copy wj_File in wj_Dir
+    WBJOB_DELETE,       // Delete wj_File (and its icon) from wj_Dir
+    WBJOB_DROP,         // Drop wj_Args (WBOPENA_* tags) into wj_Dir
+};
+
+struct wbJob {
+    struct Message  wj_Message;     // Replied to the owner's port when done.
+    struct MinNode  wj_Node;        // For use by the owner.
+    ULONG           wj_Type;        // enum wbJobType
+    BPTR            wj_Dir;         // DupLock()ed target directory.
+    STRPTR          wj_File;        // WBJOB_COPY, WBJOB_DELETE
+    struct TagItem *wj_Args;        // WBJOB_DROP; locks and names are private copies.
+    LONG            wj_TargetX;     // WBJOB_DROP
+    LONG            wj_TargetY;     // WBJOB_DROP
+
+    // Set by the worker.
+    volatile BOOL   wj_Active;      // The job has started.
+    struct DateStamp wj_Start;      // When the job started.
+    struct wbProgress wj_Progress;
+    BOOL            wj_Ok;
+    LONG            wj_Error;       // IoErr() of the first failure, if !wj_Ok.
+    LONG           *wj_Errors;      // WBJOB_DROP: IoErr() of each WBOPENA_ArgName, or 0.
+
+    // Private to the worker.
+#define WBJOB_DEVICES   4
+    APTR            wj_Device[WBJOB_DEVICES];   // Filesystems the job uses.
+    ULONG           wj_DeviceCount;
+    BOOL            wj_AnyDevice;   // Uses more devices than wj_Device holds, so runs alone.
+};
+
+// The job that owns a wj_Node.
+#define wbJobFromNode(node) ((struct wbJob *)((UBYTE *)(node) - offsetof(struct wbJob, wj_Node)))
+
+struct wbWorker;
+
+// Start the worker. Finished jobs are replied to 'port'.
+//
+// Jobs on different devices run at the same time. Jobs on the same device
+// run in order, at most ENV:Workbook/JobsPerDevice (default 1) at a time.
+// A job on more than WBJOB_DEVICES devices runs on its own, in order with
+// all of the others.
+struct wbWorker *_wbWorkerCreate(struct Library *_DOSBase, struct MsgPort *port);
+#define wbWorkerCreate(port) _wbWorkerCreate(DOSBase, port)
+
+// Stop the worker, after all queued jobs have been replied.
+void wbWorkerDelete(struct wbWorker *wbw);
+
+// Create a job. 'dir' is not consumed, and 'args' is copied.
+struct wbJob *_wbJobNew(struct Library *_DOSBase, struct Library *_UtilityBase, ULONG type, BPTR dir, CONST_STRPTR file, struct TagItem *args, LONG targetX, LONG targetY);
+#define wbJobNew(type, dir, file, args, targetX, targetY) _wbJobNew(DOSBase, UtilityBase, type, dir, file, args, targetX, targetY)
+void _wbJobFree(struct Library *_DOSBase, struct Library *_UtilityBase, struct wbJob *job);
+#define wbJobFree(job) _wbJobFree(DOSBase, UtilityBase, job)
+
+// Queue a job on the worker.
+void wbWorkerQueue(struct wbWorker *wbw, struct wbJob *job);
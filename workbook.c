@@ -164,6 +164,8 @@ ULONG WorkbookMain(void)
     if (!wb)
         goto error;
 
+    InitSemaphore(&wb->wb_Imagery);
+
     wb->wb_DOSBase = OpenLibrary("dos.library", 0);
     if (wb->wb_DOSBase == NULL)
         goto error;
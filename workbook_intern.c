@@ -7,6 +7,7 @@
  */
 
 #include <stdio.h>
+#include <stddef.h>
 
 #include <proto/dos.h>
 #include <proto/gadtools.h>
@@ -327,6 +328,174 @@ VOID wbPopupIoErr(struct WorkbookBase *wb, CONST_STRPTR title, LONG ioerr, CONST
     EasyRequest(0, &es, 0, buff);
 }
 
+// Size of a pooled block, kept in front of it. It is padded out to 8 bytes
+// (and to an IPTR), so the block is as aligned as AllocPooled() memory is.
+union wbPooledHeader {
+    ULONG  wph_Size;
+    IPTR   wph_IPTR;
+    double wph_Align;
+};
+
+APTR wbAllocPooled(APTR pool, ULONG size)
+{
+    if (pool == NULL) {
+        return AllocVec(size, MEMF_ANY);
+    }
+
+    union wbPooledHeader *mem = AllocPooled(pool, sizeof(*mem) + size);
+    if (mem == NULL) {
+        return NULL;
+    }
+
+    mem->wph_Size = sizeof(*mem) + size;
+
+    return &mem[1];
+}
+
+void wbFreePooled(APTR pool, APTR mem)
+{
+    if (mem == NULL) {
+        return;
+    }
+
+    if (pool == NULL) {
+        FreeVec(mem);
+        return;
+    }
+
+    union wbPooledHeader *block = (union wbPooledHeader *)mem - 1;
+    FreePooled(pool, block, block->wph_Size);
+}
+
+struct wbString {
+    struct MinNode ws_Node;     // In the wst_Hash bucket for ws_Hash.
+    ULONG          ws_Count;
+    ULONG          ws_Hash;
+    char           ws_Text[1];
+};
+
+#define wbStringFromText(text) ((struct wbString *)((UBYTE *)(text) - offsetof(struct wbString, ws_Text)))
+
+static ULONG wbStringHash(CONST_STRPTR str)
+{
+    ULONG hash = 0;
+
+    for (; *str != 0; str++) {
+        hash = hash * 31 + (UBYTE)*str;
+    }
+
+    return hash;
+}
+
+void wbStringTableInit(struct wbStringTable *st, APTR pool)
+{
+    st->wst_Pool = pool;
+    for (int i = 0; i < WBSTRING_HASH; i++) {
+        NEWLIST(&st->wst_Hash[i]);
+    }
+}
+
+CONST_STRPTR wbStringIntern(struct wbStringTable *st, CONST_STRPTR str)
+{
+    ULONG hash = wbStringHash(str);
+    struct wbString *ws;
+
+    if (st != NULL) {
+        ForeachNode(&st->wst_Hash[hash % WBSTRING_HASH], ws) {
+            if (ws->ws_Hash == hash && strcmp(ws->ws_Text, str) == 0) {
+                ws->ws_Count++;
+                return ws->ws_Text;
+            }
+        }
+    }
+
+    ULONG len = STRLEN(str) + 1;
+    ws = wbAllocPooled(st ? st->wst_Pool : NULL, offsetof(struct wbString, ws_Text) + len);
+    if (ws == NULL) {
+        return NULL;
+    }
+
+    ws->ws_Count = 1;
+    ws->ws_Hash = hash;
+    CopyMem(str, ws->ws_Text, len);
+    if (st != NULL) {
+        AddTailMinList(&st->wst_Hash[hash % WBSTRING_HASH], &ws->ws_Node);
+    }
+
+    return ws->ws_Text;
+}
+
+// Drop a reference to an interned string, freeing it with the last one.
+void wbStringRelease(struct wbStringTable *st, CONST_STRPTR str)
+{
+    if (str == NULL) {
+        return;
+    }
+
+    struct wbString *ws = wbStringFromText(str);
+
+    ASSERT(ws->ws_Count > 0);
+    if (--ws->ws_Count == 0) {
+        if (st != NULL) {
+            RemoveMinNode(&ws->ws_Node);
+        }
+        wbFreePooled(st ? st->wst_Pool : NULL, ws);
+    }
+}
+
+// Duplicate 'lock' into a new shared lock, with one reference.
+struct wbSharedLock *wbSharedLockNew(struct WorkbookBase *wb, BPTR lock)
+{
+    BPTR dup = DupLock(lock);
+    if (dup == BNULL) {
+        return NULL;
+    }
+
+    struct wbSharedLock *sl = wbSharedLockAdopt(wb, dup);
+    if (sl == NULL) {
+        UnLock(dup);
+    }
+
+    return sl;
+}
+
+// Make a new shared lock, with one reference, of 'lock' itself.
+// On success, 'lock' belongs to the shared lock.
+struct wbSharedLock *wbSharedLockAdopt(struct WorkbookBase *wb, BPTR lock)
+{
+    struct wbSharedLock *sl = AllocVec(sizeof(*sl), MEMF_ANY);
+    if (sl == NULL) {
+        return NULL;
+    }
+
+    sl->wsl_Lock = lock;
+    sl->wsl_Count = 1;
+    sl->wsl_Hashed = FALSE;
+
+    return sl;
+}
+
+struct wbSharedLock *wbSharedLockRef(struct wbSharedLock *sl)
+{
+    sl->wsl_Count++;
+
+    return sl;
+}
+
+// Drop a reference. The lock is released with the last one.
+void wbSharedLockRelease(struct WorkbookBase *wb, struct wbSharedLock *sl)
+{
+    if (sl == NULL) {
+        return;
+    }
+
+    ASSERT(sl->wsl_Count > 0);
+    if (--sl->wsl_Count == 0) {
+        UnLock(sl->wsl_Lock);
+        FreeVec(sl);
+    }
+}
+
 // Report all currently selected items.
 void wbDebugReportSelected_(struct WorkbookBase *wb, CONST_STRPTR caller)
 {
@@ -31,6 +31,7 @@
 #include <workbench/icon.h>
 #endif
 #include <proto/dos.h>
+#include <exec/semaphores.h>
 #include <intuition/classes.h>
 #include <intuition/intuition.h>
 
@@ -63,6 +64,11 @@ struct WorkbookBase {
 
     Object *wb_App;
     Object *wb_Backdrop;
+
+    // Held shared while an icon draws its DiskObject or list view texts,
+    // which may be on input.device's task, and exclusively while the
+    // Workbook process sheds or restores them.
+    struct SignalSemaphore wb_Imagery;
 };
 
 /* FIXME: Remove these #define xxxBase hacks
@@ -98,6 +104,37 @@ VOID wbPopupIoErr(struct WorkbookBase *wb, CONST_STRPTR title, LONG ioerr, CONST
 struct Region *wbClipWindow(struct WorkbookBase *wb, struct Window *win);
 void wbUnclipWindow(struct WorkbookBase *wb, struct Window *win, struct Region *clip);
 ULONG WorkbookMain(void);
+// Allocations from a window's memory pool. Each block remembers its size,
+// so it can be freed by itself. With no pool, AllocVec() is used.
+APTR wbAllocPooled(APTR pool, ULONG size);
+void wbFreePooled(APTR pool, APTR mem);
+// Names interned in a window's pool. Each distinct string is stored
+// once, and the immutable pointer is shared (and counted) by its users,
+// so equal strings from the same table are equal pointers.
+// With a NULL table, each intern is a private copy.
+#define WBSTRING_HASH 64
+struct wbStringTable {
+    APTR           wst_Pool;
+    struct MinList wst_Hash[WBSTRING_HASH];
+};
+void wbStringTableInit(struct wbStringTable *st, APTR pool);
+CONST_STRPTR wbStringIntern(struct wbStringTable *st, CONST_STRPTR str);
+void wbStringRelease(struct wbStringTable *st, CONST_STRPTR str);
+// A drawer lock, shared by reference between a window and its icons,
+// so that the icons don't each need a lock of their own. Icons never
+// outlive their window, which disposes them before its pool. The root
+// window's left out icons share one per drawer they are in.
+// Only used from the Workbook process, so the count needs no locking.
+struct wbSharedLock {
+    BPTR  wsl_Lock;
+    ULONG wsl_Count;
+    ULONG wsl_Hash;     // wbBackdropHashDir() of the lock's path, if wsl_Hashed.
+    BOOL  wsl_Hashed;
+};
+struct wbSharedLock *wbSharedLockNew(struct WorkbookBase *wb, BPTR lock);
+struct wbSharedLock *wbSharedLockAdopt(struct WorkbookBase *wb, BPTR lock);
+struct wbSharedLock *wbSharedLockRef(struct wbSharedLock *sl);
+void wbSharedLockRelease(struct WorkbookBase *wb, struct wbSharedLock *sl);
 void wbDebugReportSelected_(struct WorkbookBase *wb, CONST_STRPTR caller);
 #define wbDebugReportSelected(wb) wbDebugReportSelected_(wb, __func__)
 
@@ -33,6 +33,11 @@
 #define WBMENU_WB_ABOUT         4, "About...",    0, 0, 0
 #define WBMENU_WB_QUIT          5, "Quit",      "Q", 0, 0
 #define WBMENU_WB_SHUTDOWN      6, "Shutdown",    0, 0, 0
+#define WBMENU_WB_CANCEL        7, "Cancel operations", 0, 0, 0
+#define WBMENU_WB__COPY         13, "Copy options", 0, 0, 0
+#define WBMENU_WB__COPY_SYNC        14, "Sync",              0, MENUTOGGLE|CHECKIT, 0
+#define WBMENU_WB__COPY_VERIFY      15, "Verify",            0, MENUTOGGLE|CHECKIT, 0
+#define WBMENU_WB__COPY_MOVE        16, "Move between devices", 0, MENUTOGGLE|CHECKIT, 0
 #define WBMENU_WB_CUST_UPDATER  11, "Updater",    0, 0, 0
 #define WBMENU_WB_CUST_AMISTORE 12, "Amistore",   0, 0, 0
 